@@ -0,0 +1,211 @@
+/* Headless check of the draw-command merge pass (see imguiwrap.drawmerge.h).
+
+    Renders a few frames of the ImGui demo window plus a large table without opening a
+    window, then rasterizes the final frame's draw data on the CPU before and after
+    dear::OptimizeDrawData, reporting the command counts and whether any pixel differs.
+
+    The rasterizer follows what the OpenGL3 backend does with each command: the same
+    integer scissor rect, per-vertex colors, and nearest sampling of the font atlas.
+
+    Usage: draw_merge_check [frames]
+    Exits with a non-zero status if the pixels differ.
+*/
+
+#include "headless.h"
+#include "imguiwrap.dear.h"
+#include "imguiwrap.drawmerge.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+    constexpr int Width  = 1280;
+    constexpr int Height = 720;
+
+    struct Texture
+    {
+        const unsigned char* pixels_{nullptr};
+        int                  width_{0}, height_{0};
+    };
+
+    struct Color
+    {
+        float r_, g_, b_, a_;
+    };
+
+    Color
+    unpack(ImU32 col) noexcept
+    {
+        constexpr float Scale = 1.0F / 255.0F;
+        return Color{static_cast<float>((col >> IM_COL32_R_SHIFT) & 0xFFU) * Scale,
+                     static_cast<float>((col >> IM_COL32_G_SHIFT) & 0xFFU) * Scale,
+                     static_cast<float>((col >> IM_COL32_B_SHIFT) & 0xFFU) * Scale,
+                     static_cast<float>((col >> IM_COL32_A_SHIFT) & 0xFFU) * Scale};
+    }
+
+    float
+    edge(const ImVec2& a, const ImVec2& b, float x, float y) noexcept
+    {
+        return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+    }
+
+    void
+    drawTriangle(std::vector<Color>& target, const Texture& texture, const ImDrawVert& v0,
+                 const ImDrawVert& v1, const ImDrawVert& v2, int left, int top, int right,
+                 int bottom)
+    {
+        const float area = edge(v0.pos, v1.pos, v2.pos.x, v2.pos.y);
+        if (area == 0.0F) {
+            return;
+        }
+        const auto minX = std::max(left, static_cast<int>(std::floor(
+                                             std::min({v0.pos.x, v1.pos.x, v2.pos.x}))));
+        const auto maxX = std::min(right - 1, static_cast<int>(std::ceil(
+                                                  std::max({v0.pos.x, v1.pos.x, v2.pos.x}))));
+        const auto minY = std::max(top, static_cast<int>(std::floor(
+                                            std::min({v0.pos.y, v1.pos.y, v2.pos.y}))));
+        const auto maxY = std::min(bottom - 1, static_cast<int>(std::ceil(
+                                                   std::max({v0.pos.y, v1.pos.y, v2.pos.y}))));
+        const Color c0 = unpack(v0.col), c1 = unpack(v1.col), c2 = unpack(v2.col);
+
+        for (int y = minY; y <= maxY; ++y) {
+            for (int x = minX; x <= maxX; ++x) {
+                const float px = static_cast<float>(x) + 0.5F, py = static_cast<float>(y) + 0.5F;
+                const float w0 = edge(v1.pos, v2.pos, px, py) / area;
+                const float w1 = edge(v2.pos, v0.pos, px, py) / area;
+                const float w2 = edge(v0.pos, v1.pos, px, py) / area;
+                if (w0 < 0.0F || w1 < 0.0F || w2 < 0.0F) {
+                    continue;
+                }
+                const float u = w0 * v0.uv.x + w1 * v1.uv.x + w2 * v2.uv.x;
+                const float v = w0 * v0.uv.y + w1 * v1.uv.y + w2 * v2.uv.y;
+                const int   tx =
+                    std::clamp(static_cast<int>(u * static_cast<float>(texture.width_)), 0,
+                               texture.width_ - 1);
+                const int ty =
+                    std::clamp(static_cast<int>(v * static_cast<float>(texture.height_)), 0,
+                               texture.height_ - 1);
+                const auto* texels = reinterpret_cast<const ImU32*>(texture.pixels_);
+                const Color texel  = unpack(texels[ty * texture.width_ + tx]);
+
+                const Color src{(w0 * c0.r_ + w1 * c1.r_ + w2 * c2.r_) * texel.r_,
+                                (w0 * c0.g_ + w1 * c1.g_ + w2 * c2.g_) * texel.g_,
+                                (w0 * c0.b_ + w1 * c1.b_ + w2 * c2.b_) * texel.b_,
+                                (w0 * c0.a_ + w1 * c1.a_ + w2 * c2.a_) * texel.a_};
+                Color& dst = target[static_cast<size_t>(y * Width + x)];
+                dst.r_     = src.r_ * src.a_ + dst.r_ * (1.0F - src.a_);
+                dst.g_     = src.g_ * src.a_ + dst.g_ * (1.0F - src.a_);
+                dst.b_     = src.b_ * src.a_ + dst.b_ * (1.0F - src.a_);
+                dst.a_     = src.a_ + dst.a_ * (1.0F - src.a_);
+            }
+        }
+    }
+
+    std::vector<Color>
+    rasterize(const ImDrawData* drawData, const Texture& texture)
+    {
+        std::vector<Color> target(static_cast<size_t>(Width) * Height, Color{0, 0, 0, 0});
+        const auto         fbHeight = static_cast<float>(Height);
+        for (int n = 0; n < drawData->CmdListsCount; ++n) {
+            const ImDrawList* list = drawData->CmdLists[n];
+            for (const ImDrawCmd& cmd : list->CmdBuffer) {
+                if (cmd.UserCallback != nullptr) {
+                    continue;
+                }
+                // The same scissor rect the OpenGL3 backend would set.
+                const ImVec4 clip(cmd.ClipRect.x - drawData->DisplayPos.x,
+                                  cmd.ClipRect.y - drawData->DisplayPos.y,
+                                  cmd.ClipRect.z - drawData->DisplayPos.x,
+                                  cmd.ClipRect.w - drawData->DisplayPos.y);
+                if (clip.x >= static_cast<float>(Width) || clip.y >= fbHeight || clip.z < 0.0F ||
+                    clip.w < 0.0F) {
+                    continue;
+                }
+                const int glX = static_cast<int>(clip.x);
+                const int glY = static_cast<int>(fbHeight - clip.w);
+                const int glW = static_cast<int>(clip.z - clip.x);
+                const int glH = static_cast<int>(clip.w - clip.y);
+                const int left   = std::max(0, glX);
+                const int right  = std::min(Width, glX + glW);
+                const int top    = std::max(0, Height - (glY + glH));
+                const int bottom = std::min(Height, Height - glY);
+
+                const ImDrawIdx*  idx = list->IdxBuffer.Data + cmd.IdxOffset;
+                const ImDrawVert* vtx = list->VtxBuffer.Data + cmd.VtxOffset;
+                for (unsigned int i = 0; i + 2 < cmd.ElemCount; i += 3) {
+                    drawTriangle(target, texture, vtx[idx[i]], vtx[idx[i + 1]], vtx[idx[i + 2]],
+                                 left, top, right, bottom);
+                }
+            }
+        }
+        return target;
+    }
+
+    void
+    buildFrame()
+    {
+        ImGui::NewFrame();
+        ImGui::SetNextWindowPos(ImVec2(10.0F, 10.0F));
+        ImGui::SetNextWindowSize(ImVec2(600.0F, 680.0F));
+        ImGui::ShowDemoWindow();
+
+        ImGui::SetNextWindowPos(ImVec2(640.0F, 10.0F));
+        ImGui::SetNextWindowSize(ImVec2(620.0F, 680.0F));
+        dear::Begin("Table") && [] {
+            constexpr ImGuiTableFlags flags =
+                ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY;
+            dear::Table("cells", 6, flags) && [] {
+                for (int row = 0; row < 200; ++row) {
+                    ImGui::TableNextRow();
+                    for (int column = 0; column < 6; ++column) {
+                        ImGui::TableSetColumnIndex(column);
+                        ImGui::Text("r%d c%d", row, column);
+                    }
+                }
+            };
+        };
+        ImGui::Render();
+    }
+}  // namespace
+
+int
+main(int argc, const char** argv)
+{
+    const int frames = argc > 1 ? std::atoi(argv[1]) : 3;
+
+    ImGuiIO& io = example::StartHeadless(
+            ImVec2(static_cast<float>(Width), static_cast<float>(Height)));
+    // Already built, so this just hands back the atlas.
+    Texture        texture;
+    unsigned char* pixels{nullptr};
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &texture.width_, &texture.height_);
+    texture.pixels_ = pixels;
+
+    for (int frame = 0; frame < frames; ++frame) {
+        buildFrame();
+    }
+
+    ImDrawData*              drawData = ImGui::GetDrawData();
+    const std::vector<Color> before   = rasterize(drawData, texture);
+    const dear::DrawMergeStats stats  = dear::OptimizeDrawData(drawData);
+    const std::vector<Color> after    = rasterize(drawData, texture);
+
+    size_t differing = 0;
+    for (size_t i = 0; i < before.size(); ++i) {
+        if (before[i].r_ != after[i].r_ || before[i].g_ != after[i].g_ ||
+            before[i].b_ != after[i].b_ || before[i].a_ != after[i].a_) {
+            ++differing;
+        }
+    }
+
+    (void) printf("draw commands: %d before, %d after (%d dropped, %d merged)\n",
+                  stats.commandsBefore_, stats.commandsAfter_, stats.dropped_, stats.merged_);
+    (void) printf("pixels differing: %zu\n", differing);
+
+    ImGui::DestroyContext();
+    return differing == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
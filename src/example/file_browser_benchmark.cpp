@@ -0,0 +1,123 @@
+/* Benchmark of dear::FileBrowser listing a big directory.
+
+    Runs headless (no window is opened): opens a FileBrowser on the directory and calls
+    Update once per 60Hz frame, as Draw would, until every entry has been listed, statted
+    and sorted into the view. Reports how long it took for the first entries to appear,
+    the slowest Update, and the time to list everything, then checks the view is in order
+    and times narrowing and clearing a filter.
+
+    To make a directory with half a million entries to try it on:
+
+        mkdir big && (cd big && seq -f "file_%06g.txt" 500000 | xargs touch)
+
+    Usage: file_browser_benchmark [directory] [frame budget in microseconds]
+*/
+
+#include "imguiwrap.filebrowser.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <utility>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double
+    millisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // update drives browser until it has nothing left to do, returning the number of
+    // frames and the slowest Update.
+    std::pair<int, double>
+    update(dear::FileBrowser& browser, bool sleep)
+    {
+        int    frames = 0;
+        double worst  = 0.0;
+        while (browser.Listing() || browser.Sorting()) {
+            const auto start = Clock::now();
+            browser.Update();
+            worst = std::max(worst, millisecondsSince(start));
+            ++frames;
+            if (sleep) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(16));
+            }
+        }
+        return {frames, worst};
+    }
+}  // namespace
+
+int
+main(int argc, const char** argv)
+{
+    const char* path = argc > 1 ? argv[1] : ".";
+
+    const auto        start = Clock::now();
+    dear::FileBrowser browser(path);
+    if (argc > 2) {
+        browser.SetFrameBudget(std::chrono::microseconds(std::atoi(argv[2])));
+    }
+
+    // First entries: keep updating, one frame at a time, until some show up.
+    int    frames = 0;
+    double worst  = 0.0;
+    while (browser.View().empty() && (browser.Listing() || browser.Sorting())) {
+        const auto frame = Clock::now();
+        browser.Update();
+        worst = std::max(worst, millisecondsSince(frame));
+        ++frames;
+        if (browser.View().empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    const double first = millisecondsSince(start);
+
+    const auto rest = update(browser, true);
+    frames += rest.first;
+    worst = std::max(worst, rest.second);
+    if (!browser.Error().empty()) {
+        (void) fprintf(stderr, "%s: %s\n", path, browser.Error().c_str());
+        return EXIT_FAILURE;
+    }
+
+    const auto& entries = browser.Entries();
+    const auto& view    = browser.View();
+    (void) printf("%zu entries: first shown after %.2fms, all listed and sorted after %.0fms "
+                  "(%d frames), slowest update %.2fms\n",
+                  entries.size(), first, millisecondsSince(start), frames, worst);
+
+    // Directories first, then names in case-insensitive order.
+    bool ordered = view.size() == entries.size();
+    for (size_t i = 1; ordered && i < view.size(); ++i) {
+        const dear::FileEntry& lhs = entries[view[i - 1]];
+        const dear::FileEntry& rhs = entries[view[i]];
+        if (lhs.directory_ != rhs.directory_) {
+            ordered = lhs.directory_;
+            continue;
+        }
+        ordered = !std::lexicographical_compare(
+            rhs.name_.begin(), rhs.name_.end(), lhs.name_.begin(), lhs.name_.end(),
+            [](unsigned char r, unsigned char l) { return std::tolower(r) < std::tolower(l); });
+    }
+    (void) printf("view %s\n", ordered ? "in order" : "OUT OF ORDER");
+
+    auto filterStart = Clock::now();
+    browser.SetFilter("00");
+    browser.SetFilter("001");
+    (void) printf("narrowing the filter: %.2fms, %zu entries match\n",
+                  millisecondsSince(filterStart), view.size());
+
+    filterStart = Clock::now();
+    browser.SetFilter("");
+    const auto cleared = update(browser, false);
+    (void) printf("clearing the filter: %d updates, %.0fms, slowest %.2fms\n", cleared.first,
+                  millisecondsSince(filterStart), cleared.second);
+
+    return ordered ? EXIT_SUCCESS : EXIT_FAILURE;
+}
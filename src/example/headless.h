@@ -0,0 +1,24 @@
+#pragma once
+
+// Shared setup for the benchmarks and checks that run without opening a window.
+
+#include "imgui.h"
+
+namespace example
+{
+    // StartHeadless creates an ImGui context for a display of the given size, with no
+    // imgui.ini and the font atlas built, so frames can be run without a backend.
+    inline ImGuiIO&
+    StartHeadless(const ImVec2& displaySize = ImVec2(1280.0F, 720.0F)) noexcept
+    {
+        ImGui::CreateContext();
+        ImGuiIO& io    = ImGui::GetIO();
+        io.DisplaySize = displaySize;
+        io.DeltaTime   = 1.0F / 60.0F;
+        io.IniFilename = nullptr;
+        unsigned char* pixels{nullptr};
+        int            width{0}, height{0};
+        io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+        return io;
+    }
+}  // namespace example
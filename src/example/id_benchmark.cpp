@@ -0,0 +1,114 @@
+/* Benchmark of the ways of giving rows in a large list unique IDs.
+
+    Runs headless (no window is opened): it creates an ImGui context, and for each
+    strategy times pushing a per-row ID, computing the ID of a widget within the row,
+    and popping the ID again, over a large number of rows:
+
+        string:     snprintf a label per row and dear::WithID(label),
+        int:        dear::WithID(row),
+        precomputed dear::WithID(dear::ID) with IDs hashed once, up front.
+
+    It also checks that dear::HashID agrees with ImGui's own hashing.
+
+    Usage: id_benchmark [rows] [frames]
+*/
+
+#include "headless.h"
+#include "imguiwrap.dear.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace dear::literals;
+
+namespace
+{
+    constexpr dear::ID BenchWindow = "Benchmark"_id;
+
+    // Keep the compiler from discarding the IDs being computed.
+    volatile ImGuiID sink;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+    template<typename RowFn>
+    double
+    timeRows(int rows, int frames, RowFn&& rowFn)
+    {
+        double best = 1e30;
+        for (int frame = 0; frame < frames; ++frame) {
+            ImGui::NewFrame();
+            dear::Begin("Benchmark") && [&] {
+                const auto start = std::chrono::steady_clock::now();
+                for (int row = 0; row < rows; ++row) {
+                    rowFn(row);
+                }
+                const std::chrono::duration<double, std::milli> elapsed =
+                    std::chrono::steady_clock::now() - start;
+                best = std::min(best, elapsed.count());
+            };
+            ImGui::Render();
+        }
+        return best;
+    }
+
+    bool
+    checkHashes()
+    {
+        bool ok = true;
+        ImGui::NewFrame();
+        dear::Begin("Benchmark") && [&] {
+            ok &= ImGui::GetID("OK") == dear::HashID("OK", BenchWindow);
+            ok &= ImGui::GetID("Label###key") == dear::HashID("###key", BenchWindow);
+            dear::WithID(42) && [&] {
+                ok &= ImGui::GetID("value") == dear::HashID("value", dear::HashID(42, BenchWindow));
+            };
+            dear::WithID("row") && [&] {
+                ok &= ImGui::GetID("value") ==
+                      dear::HashID("value", dear::HashID("row", BenchWindow));
+            };
+        };
+        ImGui::Render();
+        return ok;
+    }
+}  // namespace
+
+int
+main(int argc, const char** argv)
+{
+    const int rows   = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const int frames = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    example::StartHeadless();
+
+    if (!checkHashes()) {
+        (void) fprintf(stderr, "dear::HashID does not match ImGui's ID hashing\n");
+        return EXIT_FAILURE;
+    }
+
+    const double byString = timeRows(rows, frames, [](int row) {
+        char label[32];
+        (void) snprintf(label, sizeof(label), "row%d", row);
+        dear::WithID(label) && [] { sink = ImGui::GetID("value"); };
+    });
+
+    const double byInt = timeRows(rows, frames, [](int row) {
+        dear::WithID(row) && [] { sink = ImGui::GetID("value"); };
+    });
+
+    std::vector<dear::ID> rowIDs(static_cast<size_t>(rows));
+    for (int row = 0; row < rows; ++row) {
+        rowIDs[static_cast<size_t>(row)] = dear::HashID(row, BenchWindow);
+    }
+    const double precomputed = timeRows(rows, frames, [&](int row) {
+        dear::WithID(rowIDs[static_cast<size_t>(row)]) && [] { sink = ImGui::GetID("value"); };
+    });
+
+    (void) printf("%d rows, best of %d frames:\n", rows, frames);
+    (void) printf("  string      %8.3f ms\n", byString);
+    (void) printf("  int         %8.3f ms\n", byInt);
+    (void) printf("  precomputed %8.3f ms\n", precomputed);
+
+    ImGui::DestroyContext();
+    return EXIT_SUCCESS;
+}
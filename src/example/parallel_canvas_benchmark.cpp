@@ -0,0 +1,114 @@
+/* Benchmark of dear::ParallelCanvas against drawing on the UI thread.
+
+    Runs headless (no window is opened): it creates an ImGui context, and times drawing a
+    scatter plot of filled circles joined by lines into a window's draw list, first
+    directly and then through dear::ParallelCanvas, checking that both produce the same
+    vertices.
+
+    Usage: parallel_canvas_benchmark [points] [frames]
+*/
+
+#include "headless.h"
+#include "imguiwrap.dear.h"
+#include "imguiwrap.parallelcanvas.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    struct Point
+    {
+        ImVec2 pos_;
+        ImU32  color_;
+    };
+
+    void
+    drawPoints(ImDrawList& list, const std::vector<Point>& points, size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i) {
+            const Point& point = points[i];
+            list.AddCircleFilled(point.pos_, 2.0F, point.color_, 8);
+            if (i > 0) {
+                list.AddLine(points[i - 1].pos_, point.pos_, point.color_);
+            }
+        }
+    }
+
+    // timeFrames runs frames with drawFn drawing into a window, returning the best time
+    // and leaving a copy of the last frame's vertices in vertices.
+    template<typename DrawFn>
+    double
+    timeFrames(int frames, std::vector<ImDrawVert>& vertices, DrawFn&& drawFn)
+    {
+        double best = 1e30;
+        for (int frame = 0; frame < frames; ++frame) {
+            ImGui::NewFrame();
+            ImGui::SetNextWindowPos(ImVec2(0.0F, 0.0F));
+            ImGui::SetNextWindowSize(ImVec2(1280.0F, 720.0F));
+            dear::Begin("Canvas") && [&] {
+                ImDrawList* list  = ImGui::GetWindowDrawList();
+                const int   first = list->VtxBuffer.Size;
+
+                const auto start = std::chrono::steady_clock::now();
+                drawFn(list);
+                const std::chrono::duration<double, std::milli> elapsed =
+                    std::chrono::steady_clock::now() - start;
+                best = std::min(best, elapsed.count());
+
+                vertices.assign(list->VtxBuffer.Data + first,
+                                list->VtxBuffer.Data + list->VtxBuffer.Size);
+            };
+            ImGui::Render();
+        }
+        return best;
+    }
+}  // namespace
+
+int
+main(int argc, const char** argv)
+{
+    const size_t count  = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 1000000;
+    const int    frames = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    ImGuiIO& io = example::StartHeadless();
+    // As the OpenGL3 backend would, so draw lists can exceed 64K vertices.
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+
+    std::vector<Point> points(count);
+    for (size_t i = 0; i < count; ++i) {
+        const auto t = static_cast<float>(i) / static_cast<float>(count);
+        points[i]    = Point{ImVec2(640.0F + 600.0F * t * std::cos(t * 500.0F),
+                                 360.0F + 340.0F * t * std::sin(t * 700.0F)),
+                          IM_COL32(static_cast<int>(t * 255.0F), 128, 255, 255)};
+    }
+
+    std::vector<ImDrawVert> serial, parallel;
+    const double            serialMs = timeFrames(frames, serial, [&](ImDrawList* list) {
+        drawPoints(*list, points, 0, points.size());
+    });
+    const double            parallelMs = timeFrames(frames, parallel, [&](ImDrawList* list) {
+        dear::ParallelCanvas(list, points.size()) &&
+            [&](ImDrawList& chunk, size_t begin, size_t end) {
+                drawPoints(chunk, points, begin, end);
+            };
+    });
+
+    const bool same = serial.size() == parallel.size() &&
+                      memcmp(serial.data(), parallel.data(),
+                             serial.size() * sizeof(ImDrawVert)) == 0;
+
+    (void) printf("%zu points, %zu vertices\n", count, serial.size());
+    (void) printf("ui thread:       %8.3fms\n", serialMs);
+    (void) printf("parallel canvas: %8.3fms (%.2fx)\n", parallelMs, serialMs / parallelMs);
+    (void) printf("vertices %s\n", same ? "match" : "DIFFER");
+
+    dear::detail::CanvasShutdown();
+    ImGui::DestroyContext();
+    return same ? EXIT_SUCCESS : EXIT_FAILURE;
+}
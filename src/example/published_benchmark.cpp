@@ -0,0 +1,150 @@
+/* Contention benchmark of dear::Published against a mutex-guarded struct.
+
+    Runs headless (no window is opened): for 1, 2, 4 and 8 writer threads publishing
+    snapshots of a 256-byte state flat out, a reader thread standing in for the UI takes
+    the newest snapshot as often as it can, either with dear::Published::Acquire or by
+    locking a std::mutex and copying the state. Every snapshot is checked for tearing, and
+    the writer and reader rates and the reader's worst wait are reported.
+
+    Usage: published_benchmark [milliseconds per run]
+*/
+
+#include "imguiwrap.published.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // State is what the writers publish: every field holds the same stamp, so a torn
+    // snapshot shows up as a mismatch.
+    struct State
+    {
+        uint64_t values_[32]{};
+
+        void Fill(uint64_t stamp) noexcept
+        {
+            std::fill(std::begin(values_), std::end(values_), stamp);
+        }
+
+        bool Consistent() const noexcept
+        {
+            return std::all_of(std::begin(values_), std::end(values_),
+                               [this](uint64_t value) { return value == values_[0]; });
+        }
+    };
+
+    struct Result
+    {
+        double   writesPerSec_{0.0};
+        double   readsPerSec_{0.0};
+        double   worstReadUs_{0.0};
+        uint64_t torn_{0};
+    };
+
+    // run starts writers threads calling write(stamp) until the time is up, while the
+    // calling thread times read() calls, which return false for a torn snapshot.
+    template<typename WriteFn, typename ReadFn>
+    Result
+    run(int writers, std::chrono::milliseconds duration, WriteFn&& write, ReadFn&& read)
+    {
+        std::atomic<bool>        stop{false};
+        std::atomic<uint64_t>    writes{0};
+        std::vector<std::thread> threads;
+        for (int i = 0; i < writers; ++i) {
+            threads.emplace_back([&, i] {
+                uint64_t count = 0;
+                for (auto stamp = static_cast<uint64_t>(i) << 48U; !stop.load(); ++stamp) {
+                    write(stamp);
+                    ++count;
+                }
+                writes += count;
+            });
+        }
+
+        Result            result{};
+        uint64_t          reads = 0;
+        const auto        start = Clock::now();
+        Clock::time_point now   = start;
+        while (now - start < duration) {
+            const auto before = Clock::now();
+            if (!read()) {
+                ++result.torn_;
+            }
+            now                 = Clock::now();
+            result.worstReadUs_ = std::max(result.worstReadUs_,
+                                           std::chrono::duration<double, std::micro>(now - before)
+                                               .count());
+            ++reads;
+        }
+        stop = true;
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        result.writesPerSec_ = static_cast<double>(writes.load()) / seconds;
+        result.readsPerSec_  = static_cast<double>(reads) / seconds;
+        return result;
+    }
+
+    void
+    report(const char* name, int writers, const Result& result)
+    {
+        (void) printf("%-16s %d writers: %10.0f writes/s %10.0f reads/s, worst read %8.1fus, "
+                      "%llu torn\n",
+                      name, writers, result.writesPerSec_, result.readsPerSec_,
+                      result.worstReadUs_, static_cast<unsigned long long>(result.torn_));
+    }
+}  // namespace
+
+int
+main(int argc, const char** argv)
+{
+    const std::chrono::milliseconds duration(argc > 1 ? std::atoi(argv[1]) : 500);
+
+    uint64_t torn = 0;
+    for (const int writers : {1, 2, 4, 8}) {
+        dear::Published<State> published(writers);
+        const Result           lockFree = run(
+            writers, duration,
+            [&published](uint64_t stamp) {
+                published.Write([stamp](State& state) { state.Fill(stamp); });
+            },
+            [&published] {
+                (void) published.Acquire();
+                return published.Get().Consistent();
+            });
+        report("dear::Published", writers, lockFree);
+
+        std::mutex   mutex;
+        State        shared;
+        const Result locked = run(
+            writers, duration,
+            [&](uint64_t stamp) {
+                const std::lock_guard<std::mutex> lock(mutex);
+                shared.Fill(stamp);
+            },
+            [&] {
+                State copy;
+                {
+                    const std::lock_guard<std::mutex> lock(mutex);
+                    copy = shared;
+                }
+                return copy.Consistent();
+            });
+        report("std::mutex", writers, locked);
+
+        torn += lockFree.torn_ + locked.torn_;
+    }
+
+    return torn == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,163 @@
+/* Benchmark of dear::SharedSeries with a producer process pushing samples flat out.
+
+    Runs headless (no window is opened): it forks a child that publishes samples of four
+    channels through dear::SeriesProducer as fast as it can, and meanwhile runs ImGui frames
+    in the parent that plot and summarize the latest samples of each channel directly from
+    shared memory. For comparison it also times parsing the same number of samples from
+    text, as a socket-based feed would have to every frame.
+
+    Usage: shared_series_benchmark [samples per frame] [frames]
+*/
+
+#include "headless.h"
+#include "imguiwrap.dear.h"
+#include "imguiwrap.seriesproducer.h"
+#include "imguiwrap.sharedseries.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr const char* SeriesName = "imguiwrap.shared_series_benchmark";
+    constexpr size_t      Channels   = 4;
+    constexpr size_t      Batch      = 64;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    volatile sig_atomic_t stopProducer{0};
+
+    void
+    produce()
+    {
+        (void) signal(SIGTERM, [](int) { stopProducer = 1; });
+        const char*          names[Channels] = {"sine", "cosine", "sawtooth", "noise"};
+        dear::SeriesProducer producer(SeriesName, names, Channels, 1 << 20);
+        if (!producer.IsOpen()) {
+            (void) fprintf(stderr, "producer: couldn't create %s\n", SeriesName);
+            return;
+        }
+        float    samples[Batch * Channels];
+        uint64_t n = 0;
+        while (stopProducer == 0) {
+            for (size_t i = 0; i < Batch; ++i, ++n) {
+                const auto t = static_cast<float>(n) * 0.001F;
+                samples[i * Channels + 0] = std::sin(t);
+                samples[i * Channels + 1] = std::cos(t);
+                samples[i * Channels + 2] = static_cast<float>(n % 1000) / 1000.0F;
+                samples[i * Channels + 3] = static_cast<float>((n * 2654435761U) % 1024) / 1024.0F;
+            }
+            producer.Push(samples, Batch);
+        }
+    }
+
+    template<typename Fn>
+    double
+    timeMs(Fn&& fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+            .count();
+    }
+}  // namespace
+
+int
+main(int argc, const char** argv)
+{
+    const size_t samples = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 100000;
+    const int    frames  = argc > 2 ? std::atoi(argv[2]) : 300;
+
+    const pid_t producer = fork();
+    if (producer == 0) {
+        produce();
+        return EXIT_SUCCESS;
+    }
+
+    dear::SharedSeries series;
+    for (int attempt = 0; attempt < 1000 && !series.Open(SeriesName); ++attempt) {
+        usleep(1000);
+    }
+    if (!series.IsOpen() || producer < 0) {
+        (void) fprintf(stderr, "couldn't open %s\n", SeriesName);
+        return EXIT_FAILURE;
+    }
+
+    example::StartHeadless();
+
+    double   readMs{0.0}, worstMs{0.0};
+    int      torn{0};
+    double   checksum{0.0};
+    uint64_t firstWritten = series.Written();
+    auto     started      = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        ImGui::NewFrame();
+        ImGui::SetNextWindowPos(ImVec2(0.0F, 0.0F));
+        ImGui::SetNextWindowSize(ImVec2(1280.0F, 720.0F));
+        dear::Begin("Metrics") && [&] {
+            const double ms = timeMs([&] {
+                const dear::SeriesView view = series.Latest(samples);
+                for (size_t channel = 0; channel < Channels; ++channel) {
+                    float low{FLT_MAX}, high{-FLT_MAX};
+                    for (size_t i = 0; i < view.Size(); ++i) {
+                        const float value = view.At(channel, i);
+                        low               = std::min(low, value);
+                        high              = std::max(high, value);
+                    }
+                    checksum += static_cast<double>(high - low);
+                    series.PlotLines(series.ChannelName(channel), channel, samples,
+                                     ImVec2(1200.0F, 150.0F), -1.0F, 1.0F);
+                }
+                torn += series.Intact(view) ? 0 : 1;
+            });
+            readMs += ms;
+            worstMs = std::max(worstMs, ms);
+        };
+        ImGui::Render();
+    }
+    const double elapsedS =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    const uint64_t published = series.Written() - firstWritten;
+
+    (void) kill(producer, SIGTERM);
+    (void) waitpid(producer, nullptr, 0);
+
+    // The socket-style equivalent: the same samples as text, parsed every frame.
+    std::string text;
+    for (size_t i = 0; i < samples * Channels; ++i) {
+        text += std::to_string(std::sin(static_cast<float>(i) * 0.001F));
+        text += '\n';
+    }
+    std::vector<float> parsed(samples * Channels);
+    double             parseMs = timeMs([&] {
+        for (int frame = 0; frame < 10; ++frame) {
+            const char* cursor = text.c_str();
+            for (float& value : parsed) {
+                char* next = nullptr;
+                value      = std::strtof(cursor, &next);
+                cursor     = next;
+            }
+        }
+    }) / 10.0;
+
+    (void) printf("%zu samples x %zu channels per frame, %d frames (checksum %.1f)\n", samples,
+                  Channels, frames, checksum);
+    (void) printf("producer:     %8.2fM samples/s\n",
+                  static_cast<double>(published) / elapsedS / 1e6);
+    (void) printf("shared read:  %8.3fms avg, %.3fms worst per frame (incl. plots), %d torn\n",
+                  readMs / frames, worstMs, torn);
+    (void) printf("text parse:   %8.3fms per frame (no plots)\n", parseMs);
+
+    series.Close();
+    ImGui::DestroyContext();
+    return EXIT_SUCCESS;
+}
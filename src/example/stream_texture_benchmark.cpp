@@ -0,0 +1,92 @@
+/* Benchmark of dear::StreamTexture with a producer thread publishing frames flat out.
+
+    Opens a window with imgui_main (vsync off) showing a stream texture, while a worker
+    thread renders a moving gradient into it as fast as it can, and reports how many frames
+    were published, uploaded and dropped, the UI-thread cost of each upload and the upload
+    throughput. To run it on Mesa's software renderer without a display:
+
+        LIBGL_ALWAYS_SOFTWARE=1 xvfb-run ./stream_texture_benchmark
+
+    Usage: stream_texture_benchmark [width] [height] [frames]
+*/
+
+#include "imguiwrap.dear.h"
+#include "imguiwrap.streamtexture.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+int
+main(int argc, const char** argv)
+{
+    const int width  = argc > 1 ? std::atoi(argv[1]) : 1920;
+    const int height = argc > 2 ? std::atoi(argv[2]) : 1080;
+    const int frames = argc > 3 ? std::atoi(argv[3]) : 600;
+
+    dear::StreamTexture texture(width, height);
+
+    std::atomic<bool> stop{false};
+    std::thread       producer([&texture, &stop] {
+        for (uint32_t frame = 0; !stop.load(std::memory_order_relaxed); ++frame) {
+            uint8_t* pixels = texture.BeginFrame();
+            for (int y = 0; y < texture.Height(); ++y) {
+                for (int x = 0; x < texture.Width(); ++x, pixels += 4) {
+                    pixels[0] = static_cast<uint8_t>(x + frame);
+                    pixels[1] = static_cast<uint8_t>(y + frame);
+                    pixels[2] = static_cast<uint8_t>(frame);
+                    pixels[3] = 0xFF;
+                }
+            }
+            texture.EndFrame();
+        }
+    });
+
+    ImGuiWrapConfig config{};
+    config.windowTitle_ = "stream_texture_benchmark";
+    config.enableVsync_ = false;
+
+    int        frame    = 0;
+    uint64_t   shown    = 0;
+    bool       ordered  = true;
+    const auto start    = std::chrono::steady_clock::now();
+    const int  exitCode = imgui_main(config, [&]() -> ImGuiWrapperReturnType {
+        // Frames must never be shown out of order.
+        ordered = ordered && texture.Sequence() >= shown;
+        shown   = texture.Sequence();
+
+        const dear::StreamTextureStats stats = texture.Stats();
+        dear::Begin("Stream") && [&] {
+            ImGui::Text("frame %llu, %.2fms per upload, %.0f MB/s",
+                        static_cast<unsigned long long>(shown),
+                        static_cast<double>(stats.uploadMs_),
+                        static_cast<double>(stats.uploadMBps_));
+            texture.Image(ImVec2(static_cast<float>(width) / 2.0F,
+                                 static_cast<float>(height) / 2.0F));
+        };
+        if (++frame < frames) {
+            return {};
+        }
+        return stats.uploaded_ > 0 && ordered ? EXIT_SUCCESS : EXIT_FAILURE;
+    });
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    stop = true;
+    producer.join();
+
+    const dear::StreamTextureStats stats = texture.Stats();
+    (void) printf("%dx%d RGBA, %d UI frames in %.2fs (%.1f fps), %s\n", width, height, frame,
+                  elapsed.count(), frame / elapsed.count(),
+                  stats.pixelBuffers_ ? "pixel buffer uploads" : "direct uploads");
+    (void) printf("published %llu, uploaded %llu, dropped %llu\n",
+                  static_cast<unsigned long long>(stats.published_),
+                  static_cast<unsigned long long>(stats.uploaded_),
+                  static_cast<unsigned long long>(stats.dropped_));
+    (void) printf("upload: %.3fms on the UI thread, %.0f MB/s, frame age %.2fms\n",
+                  static_cast<double>(stats.uploadMs_), static_cast<double>(stats.uploadMBps_),
+                  static_cast<double>(stats.ageMs_));
+    (void) printf("frames %s\n", ordered ? "in order" : "OUT OF ORDER");
+    return exitCode;
+}
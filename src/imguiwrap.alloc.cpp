@@ -0,0 +1,571 @@
+#include "imguiwrap.alloc.h"
+
+#include "imgui.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+#if defined(_WIN32)
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#    include <sys/mman.h>
+#endif
+
+namespace
+{
+    // Every block carries a 16-byte header recording which pool it came from, because
+    // ImGui's free function doesn't tell us the size. 16 bytes also preserves the
+    // alignment malloc would have given us.
+    struct alignas(16) BlockHeader
+    {
+        uint32_t sizeClass_;
+        uint32_t unused_;
+        size_t   requested_;
+    };
+    static_assert(sizeof(BlockHeader) == 16);
+
+    // FreeBlock overlays an unused block in a free list.
+    struct FreeBlock
+    {
+        FreeBlock* next_;
+    };
+
+    // Block sizes (including the header) for each size class.
+    constexpr std::array<size_t, 8> ClassSizes{32, 64, 128, 256, 512, 1024, 2048, 4096};
+    constexpr uint32_t              ClassCount = ClassSizes.size();
+    constexpr uint32_t              LargeClass = ClassCount;
+
+    // Thread caches exchange blocks with the shared pool in batches of this size, and
+    // give half back when they hold more than twice this many.
+    constexpr uint32_t BatchSize = 32;
+
+    constexpr size_t RegularSlabSize = size_t{256} * 1024;
+    constexpr size_t HugeSlabSize    = size_t{2} * 1024 * 1024;
+
+    constexpr uint32_t
+    sizeClassFor(size_t blockSize) noexcept
+    {
+        for (uint32_t i = 0; i < ClassCount; ++i) {
+            if (blockSize <= ClassSizes[i]) {
+                return i;
+            }
+        }
+        return LargeClass;
+    }
+
+    // osAllocate obtains a slab from the OS, optionally trying for huge pages first.
+    void*
+    osAllocate(size_t bytes, bool tryHuge, bool* gotHuge) noexcept
+    {
+        *gotHuge = false;
+#if defined(_WIN32)
+        if (tryHuge) {
+            const SIZE_T largePage = GetLargePageMinimum();
+            if (largePage != 0 && bytes % largePage == 0) {
+                void* mem = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                                         PAGE_READWRITE);
+                if (mem != nullptr) {
+                    *gotHuge = true;
+                    return mem;
+                }
+            }
+        }
+        return VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#elif defined(__unix__) || defined(__APPLE__)
+#    if defined(MAP_HUGETLB)
+        if (tryHuge) {
+            void* mem = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (mem != MAP_FAILED) {
+                *gotHuge = true;
+                return mem;
+            }
+        }
+#    endif
+        void* mem =
+            mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED) {
+            return nullptr;
+        }
+#    if defined(MADV_HUGEPAGE)
+        // Transparent huge pages are the next best thing when no hugetlb pages are reserved.
+        if (tryHuge && madvise(mem, bytes, MADV_HUGEPAGE) == 0) {
+            *gotHuge = true;
+        }
+#    endif
+        return mem;
+#else
+        (void) tryHuge;
+        return std::malloc(bytes);
+#endif
+    }
+
+    // SharedPool owns the slabs and the free lists that thread caches refill from.
+    struct SharedPool
+    {
+        std::mutex                         mutex_;
+        std::array<FreeBlock*, ClassCount> freeLists_{};
+        char*                              cursor_{nullptr};
+        char*                              end_{nullptr};
+        size_t                             slabSize_{RegularSlabSize};
+        bool                               tryHuge_{false};
+
+        // refill hands up to 'count' blocks of the given class to the caller as a list,
+        // returning the number provided.
+        uint32_t refill(uint32_t sizeClass, uint32_t count, FreeBlock** head) noexcept;
+
+        // release takes back a list of blocks.
+        void release(uint32_t sizeClass, FreeBlock* first, FreeBlock* last) noexcept
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            last->next_           = freeLists_[sizeClass];
+            freeLists_[sizeClass] = first;
+        }
+    };
+
+    // Counters that aren't updated per allocation are global atomics so they can be read
+    // from any thread.
+    struct Counters
+    {
+        std::atomic<bool>     installed_{false};
+        std::atomic<bool>     pooled_{false};
+        std::atomic<bool>     hugePages_{false};
+        std::atomic<size_t>   peakBytes_{0};
+        std::atomic<size_t>   reservedBytes_{0};
+        std::atomic<uint64_t> lastFrameAllocations_{0};
+        std::atomic<uint64_t> lastFrameFrees_{0};
+
+        // frame_ is advanced at each frame boundary, when boundaryLive_ is the total live
+        // bytes; threads restart their high-water marks the first time they see it change.
+        std::atomic<uint32_t> frame_{1};
+        std::atomic<int64_t>  boundaryLive_{0};
+
+        // Totals at the last frame boundary; UI thread.
+        uint64_t boundaryAllocations_{0};
+        uint64_t boundaryFrees_{0};
+    };
+
+    // ThreadCounters are the per-allocation counters of one thread, kept apart so that
+    // threads allocating at the same time don't bounce a shared cache line between them.
+    // Only the owning thread writes them, so it updates them with plain loads and stores
+    // rather than read-modify-writes; readers sum every thread's counters. Memory freed
+    // on another thread than allocated it makes a thread's live counts negative, but the
+    // sums are right.
+    struct alignas(64) ThreadCounters
+    {
+        std::atomic<int64_t>  liveBytes_{0};
+        std::atomic<int64_t>  liveAllocations_{0};
+        std::atomic<uint64_t> allocations_{0};
+        std::atomic<uint64_t> frees_{0};
+        std::atomic<uint64_t> largeAllocations_{0};
+
+        // The thread's live bytes when it first allocated or freed in frame frame_, and the
+        // most it has held since; unused by the shared block.
+        std::atomic<int64_t>  frameStart_{0};
+        std::atomic<int64_t>  frameHigh_{0};
+        std::atomic<uint32_t> frame_{0};
+
+        // inUse_ is cleared when the owning thread exits, so that a new thread can carry
+        // on from its counts; the blocks themselves are never freed.
+        std::atomic<bool> inUse_{true};
+        ThreadCounters*   next_{nullptr};
+
+        // shared_ marks the block used by threads whose own block has gone, which has
+        // several writers and so has to use read-modify-writes.
+        bool shared_{false};
+
+        explicit ThreadCounters(bool shared = false) noexcept : shared_(shared) {}
+
+        template<typename T>
+        void add(std::atomic<T>& counter, T value) noexcept
+        {
+            if (shared_) {
+                counter.fetch_add(value, std::memory_order_relaxed);
+            } else {
+                counter.store(counter.load(std::memory_order_relaxed) + value,
+                              std::memory_order_relaxed);
+            }
+        }
+
+        // addLive adds to liveBytes_, keeping the frame's high-water mark up to date.
+        void addLive(int64_t bytes, uint32_t frame) noexcept
+        {
+            if (shared_) {
+                liveBytes_.fetch_add(bytes, std::memory_order_relaxed);
+                return;
+            }
+            int64_t live = liveBytes_.load(std::memory_order_relaxed);
+            if (frame_.load(std::memory_order_relaxed) != frame) {
+                frameStart_.store(live, std::memory_order_relaxed);
+                frameHigh_.store(live, std::memory_order_relaxed);
+                frame_.store(frame, std::memory_order_release);
+            }
+            live += bytes;
+            liveBytes_.store(live, std::memory_order_relaxed);
+            if (live > frameHigh_.load(std::memory_order_relaxed)) {
+                frameHigh_.store(live, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    SharedPool sharedPool;
+    // usePools is cleared when only the counting allocator is wanted; it is set before
+    // the allocator is installed and never changes afterwards.
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    bool usePools{true};
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    Counters counters;
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    std::atomic<ThreadCounters*> threadCountersList{nullptr};
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    ThreadCounters sharedCounters{true};
+
+    uint32_t
+    SharedPool::refill(uint32_t sizeClass, uint32_t count, FreeBlock** head) noexcept
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t                          provided = 0;
+        FreeBlock*                        list     = nullptr;
+
+        // Recycled blocks first.
+        while (provided < count && freeLists_[sizeClass] != nullptr) {
+            FreeBlock* block      = freeLists_[sizeClass];
+            freeLists_[sizeClass] = block->next_;
+            block->next_          = list;
+            list                  = block;
+            ++provided;
+        }
+
+        // Then carve fresh blocks from the current slab, starting a new one if needed.
+        const size_t blockSize = ClassSizes[sizeClass];
+        while (provided < count) {
+            if (cursor_ == nullptr || static_cast<size_t>(end_ - cursor_) < blockSize) {
+                bool  gotHuge = false;
+                void* slab    = osAllocate(slabSize_, tryHuge_, &gotHuge);
+                if (slab == nullptr) {
+                    break;
+                }
+                if (gotHuge) {
+                    counters.hugePages_.store(true, std::memory_order_relaxed);
+                }
+                counters.reservedBytes_.fetch_add(slabSize_, std::memory_order_relaxed);
+                cursor_ = static_cast<char*>(slab);
+                end_    = cursor_ + slabSize_;
+            }
+            auto* block  = reinterpret_cast<FreeBlock*>(cursor_);
+            cursor_     += blockSize;
+            block->next_ = list;
+            list         = block;
+            ++provided;
+        }
+
+        *head = list;
+        return provided;
+    }
+
+    // threadCacheGone is set once the current thread's cache has been destroyed, since
+    // ImGui objects with static lifetime may still be freed after that.
+    thread_local bool threadCacheGone{false};
+
+    // ThreadCache holds blocks for the current thread so that the common case needs
+    // neither a lock nor an atomic read-modify-write. Anything left over when the thread
+    // exits goes back to the shared pool.
+    struct ThreadCache
+    {
+        std::array<FreeBlock*, ClassCount> heads_{};
+        std::array<uint32_t, ClassCount>   counts_{};
+
+        ThreadCache() = default;
+        ThreadCache(const ThreadCache&) = delete;
+        ThreadCache& operator=(const ThreadCache&) = delete;
+
+        ~ThreadCache()
+        {
+            threadCacheGone = true;
+            for (uint32_t i = 0; i < ClassCount; ++i) {
+                if (heads_[i] != nullptr) {
+                    FreeBlock* last = heads_[i];
+                    while (last->next_ != nullptr) {
+                        last = last->next_;
+                    }
+                    sharedPool.release(i, heads_[i], last);
+                }
+            }
+        }
+
+        void* pop(uint32_t sizeClass) noexcept
+        {
+            if (heads_[sizeClass] == nullptr) {
+                counts_[sizeClass] = sharedPool.refill(sizeClass, BatchSize, &heads_[sizeClass]);
+                if (heads_[sizeClass] == nullptr) {
+                    return nullptr;
+                }
+            }
+            FreeBlock* block  = heads_[sizeClass];
+            heads_[sizeClass] = block->next_;
+            --counts_[sizeClass];
+            return block;
+        }
+
+        void push(uint32_t sizeClass, void* ptr) noexcept
+        {
+            auto* block       = static_cast<FreeBlock*>(ptr);
+            block->next_      = heads_[sizeClass];
+            heads_[sizeClass] = block;
+            if (++counts_[sizeClass] <= BatchSize * 2) {
+                return;
+            }
+            // Too many cached: hand a batch back so other threads can use them.
+            FreeBlock* first = heads_[sizeClass];
+            FreeBlock* last  = first;
+            for (uint32_t i = 1; i < BatchSize; ++i) {
+                last = last->next_;
+            }
+            heads_[sizeClass] = last->next_;
+            counts_[sizeClass] -= BatchSize;
+            sharedPool.release(sizeClass, first, last);
+        }
+    };
+
+    thread_local ThreadCache threadCache;
+
+    // threadCountersGone is set once the current thread's counters have been handed back.
+    thread_local bool threadCountersGone{false};
+
+    // CounterOwner claims a ThreadCounters block for the current thread: a free one left
+    // by an exited thread if there is one, otherwise a new one.
+    struct CounterOwner
+    {
+        ThreadCounters* counters_{nullptr};
+
+        CounterOwner() noexcept
+        {
+            ThreadCounters* head = threadCountersList.load(std::memory_order_acquire);
+            for (ThreadCounters* block = head; block != nullptr; block = block->next_) {
+                bool inUse = false;
+                if (block->inUse_.compare_exchange_strong(inUse, true,
+                                                          std::memory_order_acquire)) {
+                    counters_ = block;
+                    return;
+                }
+            }
+            counters_ = new (std::nothrow) ThreadCounters;
+            if (counters_ == nullptr) {
+                counters_ = &sharedCounters;
+                return;
+            }
+            counters_->next_ = head;
+            while (!threadCountersList.compare_exchange_weak(counters_->next_, counters_,
+                                                             std::memory_order_release,
+                                                             std::memory_order_relaxed)) {
+            }
+        }
+
+        CounterOwner(const CounterOwner&) = delete;
+        CounterOwner& operator=(const CounterOwner&) = delete;
+
+        ~CounterOwner()
+        {
+            threadCountersGone = true;
+            if (counters_ != &sharedCounters) {
+                counters_->inUse_.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    thread_local CounterOwner counterOwner;
+
+    ThreadCounters&
+    threadCounters() noexcept
+    {
+        return threadCountersGone ? sharedCounters : *counterOwner.counters_;
+    }
+
+    // Totals sums the counters of every thread.
+    struct Totals
+    {
+        int64_t  liveBytes_{0};
+        int64_t  liveAllocations_{0};
+        uint64_t allocations_{0};
+        uint64_t frees_{0};
+        uint64_t largeAllocations_{0};
+    };
+
+    Totals
+    sumThreadCounters() noexcept
+    {
+        Totals         totals{};
+        const uint32_t frame  = counters.frame_.load(std::memory_order_relaxed);
+        int64_t        growth = 0;  // how far threads have risen above where the frame began
+        const auto add = [&totals, &growth, frame](const ThreadCounters& block) {
+            totals.liveBytes_        += block.liveBytes_.load(std::memory_order_relaxed);
+            totals.liveAllocations_  += block.liveAllocations_.load(std::memory_order_relaxed);
+            totals.allocations_      += block.allocations_.load(std::memory_order_relaxed);
+            totals.frees_            += block.frees_.load(std::memory_order_relaxed);
+            totals.largeAllocations_ += block.largeAllocations_.load(std::memory_order_relaxed);
+            if (!block.shared_ && block.frame_.load(std::memory_order_acquire) == frame) {
+                const int64_t rise = block.frameHigh_.load(std::memory_order_relaxed) -
+                                     block.frameStart_.load(std::memory_order_relaxed);
+                growth += std::max<int64_t>(rise, 0);
+            }
+        };
+        for (ThreadCounters* block = threadCountersList.load(std::memory_order_acquire);
+             block != nullptr; block = block->next_) {
+            add(*block);
+        }
+        add(sharedCounters);
+
+        // The frame's peak is at most where it began plus each thread's own high-water mark
+        // above that; exactly that when only one thread allocates or frees during it.
+        const int64_t high = std::max(totals.liveBytes_,
+                                      counters.boundaryLive_.load(std::memory_order_relaxed) +
+                                          growth);
+        const auto    live = static_cast<size_t>(std::max<int64_t>(high, 0));
+        size_t        peak = counters.peakBytes_.load(std::memory_order_relaxed);
+        while (live > peak &&
+               !counters.peakBytes_.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+        return totals;
+    }
+
+    void
+    noteAllocation(size_t bytes, bool large) noexcept
+    {
+        ThreadCounters& mine = threadCounters();
+        mine.addLive(static_cast<int64_t>(bytes), counters.frame_.load(std::memory_order_relaxed));
+        mine.add(mine.liveAllocations_, int64_t{1});
+        mine.add(mine.allocations_, uint64_t{1});
+        if (large) {
+            mine.add(mine.largeAllocations_, uint64_t{1});
+        }
+#ifdef IMGUIWRAP_ALLOC_CHECKER
+        dear::detail::AllocCheckNote(bytes, true);
+#endif
+    }
+
+    void
+    noteFree(size_t bytes) noexcept
+    {
+        ThreadCounters& mine = threadCounters();
+        mine.addLive(-static_cast<int64_t>(bytes), counters.frame_.load(std::memory_order_relaxed));
+        mine.add(mine.liveAllocations_, int64_t{-1});
+        mine.add(mine.frees_, uint64_t{1});
+    }
+
+    void*
+    poolAlloc(size_t size, void* /*userData*/) noexcept
+    {
+        uint32_t sizeClass = sizeClassFor(size + sizeof(BlockHeader));
+        void*    block     = nullptr;
+        if (sizeClass == LargeClass || !usePools) {
+            block     = std::malloc(size + sizeof(BlockHeader));
+            sizeClass = LargeClass;
+        } else if (!threadCacheGone) {
+            block = threadCache.pop(sizeClass);
+        } else {
+            FreeBlock* head = nullptr;
+            sharedPool.refill(sizeClass, 1, &head);
+            block = head;
+        }
+        if (block == nullptr) {
+            return nullptr;
+        }
+
+        auto* header       = static_cast<BlockHeader*>(block);
+        header->sizeClass_ = sizeClass;
+        header->requested_ = size;
+        noteAllocation(size, sizeClass == LargeClass);
+        return header + 1;
+    }
+
+    void
+    poolFree(void* ptr, void* /*userData*/) noexcept
+    {
+        if (ptr == nullptr) {
+            return;
+        }
+        auto* header = static_cast<BlockHeader*>(ptr) - 1;
+        noteFree(header->requested_);
+        if (header->sizeClass_ == LargeClass) {
+            std::free(header);
+        } else if (!threadCacheGone) {
+            threadCache.push(header->sizeClass_, header);
+        } else {
+            auto* block = reinterpret_cast<FreeBlock*>(header);
+            sharedPool.release(header->sizeClass_, block, block);
+        }
+    }
+
+}  // namespace
+
+namespace dear
+{
+    AllocatorStats GetAllocatorStats() noexcept
+    {
+        const Totals   totals = sumThreadCounters();
+        AllocatorStats stats{};
+        stats.installed_        = counters.installed_.load(std::memory_order_relaxed);
+        stats.pooled_           = counters.pooled_.load(std::memory_order_relaxed);
+        stats.hugePages_        = counters.hugePages_.load(std::memory_order_relaxed);
+        stats.liveBytes_        = static_cast<size_t>(std::max<int64_t>(totals.liveBytes_, 0));
+        stats.peakBytes_        = counters.peakBytes_.load(std::memory_order_relaxed);
+        stats.liveAllocations_  = static_cast<size_t>(std::max<int64_t>(totals.liveAllocations_,
+                                                                        0));
+        stats.reservedBytes_    = counters.reservedBytes_.load(std::memory_order_relaxed);
+        stats.totalAllocations_ = totals.allocations_;
+        stats.totalFrees_       = totals.frees_;
+        stats.largeAllocations_ = totals.largeAllocations_;
+        stats.frameAllocations_ = counters.lastFrameAllocations_.load(std::memory_order_relaxed);
+        stats.frameFrees_       = counters.lastFrameFrees_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    namespace detail
+    {
+        void InstallPoolAllocator(bool hugePages) noexcept
+        {
+            if (counters.installed_.exchange(true)) {
+                // Already installed by a previous imgui_main.
+                return;
+            }
+            {
+                const std::lock_guard<std::mutex> lock(sharedPool.mutex_);
+                sharedPool.tryHuge_  = hugePages;
+                sharedPool.slabSize_ = hugePages ? HugeSlabSize : RegularSlabSize;
+            }
+            counters.pooled_.store(true, std::memory_order_relaxed);
+            ImGui::SetAllocatorFunctions(poolAlloc, poolFree, nullptr);
+        }
+
+        void InstallCountingAllocator() noexcept
+        {
+            if (counters.installed_.exchange(true)) {
+                return;
+            }
+            usePools = false;
+            ImGui::SetAllocatorFunctions(poolAlloc, poolFree, nullptr);
+        }
+
+        void AllocatorFrameBoundary() noexcept
+        {
+            const Totals totals = sumThreadCounters();
+            counters.lastFrameAllocations_.store(totals.allocations_ -
+                                                     counters.boundaryAllocations_,
+                                                 std::memory_order_relaxed);
+            counters.lastFrameFrees_.store(totals.frees_ - counters.boundaryFrees_,
+                                           std::memory_order_relaxed);
+            counters.boundaryAllocations_ = totals.allocations_;
+            counters.boundaryFrees_       = totals.frees_;
+            counters.boundaryLive_.store(totals.liveBytes_, std::memory_order_relaxed);
+            counters.frame_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }  // namespace detail
+}  // namespace dear
@@ -0,0 +1,107 @@
+#pragma once
+
+// Pooled allocator for ImGui's internal allocations.
+//
+// When ImGuiWrapConfig::poolAllocator_ is set, imgui_main installs a size-class pool
+// allocator via ImGui::SetAllocatorFunctions before creating the ImGui context, so
+// that ImVector growth, window and table state etc are served from per-thread free
+// lists instead of going to malloc every time.
+//
+// Requests larger than the biggest size class still go to malloc, but are counted.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dear
+{
+    // AllocatorStats is a snapshot of the counters maintained by the pool allocator.
+    struct AllocatorStats
+    {
+        // installed_ is false if imgui_main installed neither the pool allocator nor (for
+        // the allocation checker) the counting allocator, in which case all other values
+        // are zero. pooled_ is true only for the pool allocator; the counting allocator
+        // keeps the same counters but serves everything from malloc.
+        bool installed_{false};
+        bool pooled_{false};
+
+        // hugePages_ is true if at least one slab was successfully backed by huge pages.
+        bool hugePages_{false};
+
+        // liveBytes_ is the number of bytes currently allocated by ImGui, and peakBytes_
+        // the high-water mark of liveBytes_, including spikes freed within a frame. If
+        // several threads allocate during a frame, it is an upper bound.
+        size_t liveBytes_{0};
+        size_t peakBytes_{0};
+
+        // liveAllocations_ is the number of allocations not yet freed.
+        size_t liveAllocations_{0};
+
+        // reservedBytes_ is the amount of slab memory obtained from the OS.
+        size_t reservedBytes_{0};
+
+        // totalAllocations_/totalFrees_ count calls since the allocator was installed,
+        // of which largeAllocations_ bypassed the pools.
+        uint64_t totalAllocations_{0};
+        uint64_t totalFrees_{0};
+        uint64_t largeAllocations_{0};
+
+        // frameAllocations_/frameFrees_ count calls during the last completed frame.
+        uint64_t frameAllocations_{0};
+        uint64_t frameFrees_{0};
+    };
+
+    // GetAllocatorStats returns the current pool allocator counters.
+    extern AllocatorStats GetAllocatorStats() noexcept;
+
+    namespace detail
+    {
+        // InstallPoolAllocator routes ImGui allocations through the pool. It must be
+        // called before ImGui::CreateContext, and stays installed for the lifetime of the
+        // process since ImGui objects may outlive the context (e.g. static ImVectors).
+        extern void InstallPoolAllocator(bool hugePages) noexcept;
+
+        // InstallCountingAllocator routes ImGui allocations to malloc, but maintains the
+        // same counters as the pool allocator.
+        extern void InstallCountingAllocator() noexcept;
+
+        // AllocatorFrameBoundary rolls the per-frame counters over; imgui_main calls it
+        // at the start of every frame.
+        extern void AllocatorFrameBoundary() noexcept;
+    }  // namespace detail
+
+#ifdef IMGUIWRAP_ALLOC_CHECKER
+    // Steady-state allocation checker, built with the IMGUIWRAP_ALLOC_CHECKER cmake option
+    // and enabled by ImGuiWrapConfig::allocCheckWarmupFrames_.
+    //
+    // Once warmed up, imgui_main expects frames to perform no heap allocation on the UI
+    // thread, either via global operator new or ImGui's allocator. Allocations are
+    // attributed to the innermost dear:: scopes and either logged at the end of the frame
+    // or, with ImGuiWrapConfig::allocCheckAssert_, trigger IM_ASSERT where they happen.
+    struct AllocCheckStats
+    {
+        // warmedUp_ is true once the warm-up frames have elapsed.
+        bool warmedUp_{false};
+
+        // allocations_/bytes_ total the allocations seen after warm-up, and frames_ the
+        // number of frames that made at least one.
+        uint64_t allocations_{0};
+        uint64_t bytes_{0};
+        uint64_t frames_{0};
+    };
+
+    // GetAllocCheckStats returns the checker's counters.
+    extern AllocCheckStats GetAllocCheckStats() noexcept;
+
+    namespace detail
+    {
+        // imgui_main drives the checker through these.
+        extern void AllocCheckStart(int warmupFrames, bool assertOnAlloc) noexcept;
+        extern void AllocCheckFrameBegin() noexcept;
+        extern void AllocCheckFrameEnd() noexcept;
+        extern void AllocCheckStop() noexcept;
+
+        // AllocCheckNote is called for every allocation the checker is told about.
+        extern void AllocCheckNote(size_t bytes, bool fromImGui) noexcept;
+    }  // namespace detail
+#endif
+}  // namespace dear
@@ -0,0 +1,326 @@
+// Steady-state allocation checker: replaces the global operator new/delete so that
+// allocations made on the UI thread after the warm-up frames can be reported.
+//
+// Only built when the IMGUIWRAP_ALLOC_CHECKER cmake option is on; see imguiwrap.alloc.h.
+
+#include "imguiwrap.alloc.h"
+#include "imguiwrap.dear.h"
+
+#include "imgui_internal.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#    include <malloc.h>  // _aligned_malloc
+#endif
+
+#ifndef IMGUIWRAP_ALLOC_CHECKER
+#    error "imguiwrap.alloccheck.cpp requires IMGUIWRAP_ALLOC_CHECKER"
+#endif
+
+namespace
+{
+    // The first few offending allocations of each frame are kept for the report.
+    constexpr size_t MaxRecorded = 8;
+    constexpr size_t PathLength  = 128;
+
+    struct Offence
+    {
+        size_t bytes_;
+        bool   fromImGui_;
+        char   scope_[PathLength];
+    };
+
+    // CheckState is only ever touched from the UI thread.
+    struct CheckState
+    {
+        int  warmupFrames_{0};
+        int  frame_{0};
+        bool assert_{false};
+        bool armed_{false};
+
+        std::array<Offence, MaxRecorded> recorded_{};
+        size_t                           frameAllocations_{0};
+        size_t                           frameBytes_{0};
+
+        dear::AllocCheckStats stats_{};
+    };
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    CheckState checkState;
+
+    // uiThreadState is only set on the thread running imgui_main, so that allocations
+    // from worker threads are ignored without any synchronization.
+    thread_local CheckState* uiThreadState{nullptr};
+
+    // inHook prevents reporting from recursing into itself.
+    thread_local bool inHook{false};
+
+    void
+    describeScope(char* buffer, size_t bufferSize) noexcept
+    {
+        if (dear::detail::FormatScopePath(buffer, bufferSize) > 0) {
+            return;
+        }
+        // Not inside a dear:: scope; fall back to the ImGui window being submitted.
+        const ImGuiContext* ctx = ImGui::GetCurrentContext();
+        const char* name = (ctx != nullptr && ctx->CurrentWindow != nullptr)
+                               ? ctx->CurrentWindow->Name
+                               : "(no scope)";
+        (void) snprintf(buffer, bufferSize, "%s", name);
+    }
+
+    void*
+    checkedAlloc(size_t size) noexcept
+    {
+        dear::detail::AllocCheckNote(size, false);
+        if (size == 0) {
+            size = 1;
+        }
+        for (;;) {
+            if (void* ptr = std::malloc(size); ptr != nullptr) {
+                return ptr;
+            }
+            // Without exceptions, the only recourse is the new handler.
+            std::new_handler handler = std::get_new_handler();
+            if (handler == nullptr) {
+                std::abort();
+            }
+            handler();
+        }
+    }
+
+    void*
+    checkedAlignedAlloc(size_t size, std::align_val_t align) noexcept
+    {
+        dear::detail::AllocCheckNote(size, false);
+        const auto alignment = static_cast<size_t>(align);
+        // aligned_alloc requires the size to be a multiple of the alignment.
+        size = ((size + alignment - 1) / alignment) * alignment;
+        if (size == 0) {
+            size = alignment;
+        }
+        for (;;) {
+#if defined(_WIN32)
+            void* ptr = _aligned_malloc(size, alignment);
+#else
+            void* ptr = std::aligned_alloc(alignment, size);
+#endif
+            if (ptr != nullptr) {
+                return ptr;
+            }
+            std::new_handler handler = std::get_new_handler();
+            if (handler == nullptr) {
+                std::abort();
+            }
+            handler();
+        }
+    }
+
+    void
+    checkedAlignedFree(void* ptr) noexcept
+    {
+#if defined(_WIN32)
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+
+}  // namespace
+
+namespace dear
+{
+    AllocCheckStats GetAllocCheckStats() noexcept { return checkState.stats_; }
+
+    namespace detail
+    {
+        void AllocCheckStart(int warmupFrames, bool assertOnAlloc) noexcept
+        {
+            checkState.warmupFrames_ = warmupFrames;
+            checkState.assert_       = assertOnAlloc;
+            checkState.frame_        = 0;
+            checkState.armed_        = false;
+            checkState.stats_        = {};
+            uiThreadState            = &checkState;
+        }
+
+        void AllocCheckFrameBegin() noexcept
+        {
+            ++checkState.frame_;
+            checkState.frameAllocations_ = 0;
+            checkState.frameBytes_       = 0;
+            checkState.armed_            = checkState.frame_ > checkState.warmupFrames_;
+            checkState.stats_.warmedUp_  = checkState.armed_;
+        }
+
+        void AllocCheckFrameEnd() noexcept
+        {
+            checkState.armed_ = false;
+            if (checkState.frameAllocations_ == 0) {
+                return;
+            }
+
+            ++checkState.stats_.frames_;
+            inHook = true;
+            (void) fprintf(stderr, "imguiwrap: frame %d made %zu heap allocation(s), %zu bytes:\n",
+                           checkState.frame_, checkState.frameAllocations_,
+                           checkState.frameBytes_);
+            const size_t shown = std::min(checkState.frameAllocations_, MaxRecorded);
+            for (size_t i = 0; i < shown; ++i) {
+                const Offence& offence = checkState.recorded_[i];
+                (void) fprintf(stderr, "  %8zu bytes via %-8s in %s\n", offence.bytes_,
+                               offence.fromImGui_ ? "ImGui" : "new", offence.scope_);
+            }
+            if (shown < checkState.frameAllocations_) {
+                (void) fprintf(stderr, "  ... and %zu more\n",
+                               checkState.frameAllocations_ - shown);
+            }
+            inHook = false;
+        }
+
+        void AllocCheckStop() noexcept
+        {
+            checkState.armed_ = false;
+            uiThreadState     = nullptr;
+        }
+
+        void AllocCheckNote(size_t bytes, bool fromImGui) noexcept
+        {
+            CheckState* state = uiThreadState;
+            if (state == nullptr || !state->armed_ || inHook) {
+                return;
+            }
+            inHook = true;
+
+            if (state->frameAllocations_ < MaxRecorded) {
+                Offence& offence   = state->recorded_[state->frameAllocations_];
+                offence.bytes_     = bytes;
+                offence.fromImGui_ = fromImGui;
+                describeScope(offence.scope_, sizeof(offence.scope_));
+            }
+            ++state->frameAllocations_;
+            state->frameBytes_ += bytes;
+            ++state->stats_.allocations_;
+            state->stats_.bytes_ += bytes;
+
+            if (state->assert_) {
+                char scope[PathLength];
+                describeScope(scope, sizeof(scope));
+                (void) fprintf(stderr, "imguiwrap: %zu byte allocation in %s after warm-up\n",
+                               bytes, scope);
+                IM_ASSERT(false && "heap allocation in steady-state frame");
+            }
+
+            inHook = false;
+        }
+    }  // namespace detail
+}  // namespace dear
+
+// Global allocation function replacements.
+
+void*
+operator new(size_t size)
+{
+    return checkedAlloc(size);
+}
+void*
+operator new[](size_t size)
+{
+    return checkedAlloc(size);
+}
+void*
+operator new(size_t size, const std::nothrow_t& /*tag*/) noexcept
+{
+    return checkedAlloc(size);
+}
+void*
+operator new[](size_t size, const std::nothrow_t& /*tag*/) noexcept
+{
+    return checkedAlloc(size);
+}
+void*
+operator new(size_t size, std::align_val_t align)
+{
+    return checkedAlignedAlloc(size, align);
+}
+void*
+operator new[](size_t size, std::align_val_t align)
+{
+    return checkedAlignedAlloc(size, align);
+}
+void*
+operator new(size_t size, std::align_val_t align, const std::nothrow_t& /*tag*/) noexcept
+{
+    return checkedAlignedAlloc(size, align);
+}
+void*
+operator new[](size_t size, std::align_val_t align, const std::nothrow_t& /*tag*/) noexcept
+{
+    return checkedAlignedAlloc(size, align);
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+void
+operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+void
+operator delete(void* ptr, size_t /*size*/) noexcept
+{
+    std::free(ptr);
+}
+void
+operator delete[](void* ptr, size_t /*size*/) noexcept
+{
+    std::free(ptr);
+}
+void
+operator delete(void* ptr, const std::nothrow_t& /*tag*/) noexcept
+{
+    std::free(ptr);
+}
+void
+operator delete[](void* ptr, const std::nothrow_t& /*tag*/) noexcept
+{
+    std::free(ptr);
+}
+void
+operator delete(void* ptr, std::align_val_t /*align*/) noexcept
+{
+    checkedAlignedFree(ptr);
+}
+void
+operator delete[](void* ptr, std::align_val_t /*align*/) noexcept
+{
+    checkedAlignedFree(ptr);
+}
+void
+operator delete(void* ptr, size_t /*size*/, std::align_val_t /*align*/) noexcept
+{
+    checkedAlignedFree(ptr);
+}
+void
+operator delete[](void* ptr, size_t /*size*/, std::align_val_t /*align*/) noexcept
+{
+    checkedAlignedFree(ptr);
+}
+void
+operator delete(void* ptr, std::align_val_t /*align*/, const std::nothrow_t& /*tag*/) noexcept
+{
+    checkedAlignedFree(ptr);
+}
+void
+operator delete[](void* ptr, std::align_val_t /*align*/, const std::nothrow_t& /*tag*/) noexcept
+{
+    checkedAlignedFree(ptr);
+}
@@ -0,0 +1,225 @@
+#include "imguiwrap.cached.h"
+#include "imguiwrap.fonts.h"
+#include "imguiwrap.memo.h"
+#include "imguiwrap.parallelcanvas.h"  // SpliceDrawCommands
+
+#include "imgui_internal.h"  // ImGuiContext::WindowsActiveCount, ImGuiWindow::DC
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // The layout inputs a recording depends on, besides the caller's version.
+    struct CachedInputs
+    {
+        uint64_t      version_{0};
+        ImVec2        pos_{};
+        ImVec2        avail_{};
+        ImVec2        clipMin_{};
+        ImVec2        clipMax_{};
+        const ImFont* font_{nullptr};
+        float         fontSize_{0.0F};
+        ImTextureID   texture_{};
+        int           fontGeneration_{0};
+    };
+
+    bool
+    same(const ImVec2& lhs, const ImVec2& rhs) noexcept
+    {
+        return lhs.x == rhs.x && lhs.y == rhs.y;
+    }
+
+    bool
+    same(const CachedInputs& lhs, const CachedInputs& rhs) noexcept
+    {
+        return lhs.version_ == rhs.version_ && same(lhs.pos_, rhs.pos_) &&
+               same(lhs.avail_, rhs.avail_) && same(lhs.clipMin_, rhs.clipMin_) &&
+               same(lhs.clipMax_, rhs.clipMax_) && lhs.font_ == rhs.font_ &&
+               lhs.fontSize_ == rhs.fontSize_ && lhs.texture_ == rhs.texture_ &&
+               lhs.fontGeneration_ == rhs.fontGeneration_;
+    }
+
+    bool
+    same(const ImDrawCmd& lhs, const ImDrawCmd& rhs) noexcept
+    {
+        return lhs.ClipRect.x == rhs.ClipRect.x && lhs.ClipRect.y == rhs.ClipRect.y &&
+               lhs.ClipRect.z == rhs.ClipRect.z && lhs.ClipRect.w == rhs.ClipRect.w &&
+               lhs.TextureId == rhs.TextureId && lhs.VtxOffset == rhs.VtxOffset &&
+               lhs.IdxOffset == rhs.IdxOffset && lhs.ElemCount == rhs.ElemCount &&
+               lhs.UserCallback == rhs.UserCallback &&
+               lhs.UserCallbackData == rhs.UserCallbackData;
+    }
+
+    CachedInputs
+    currentInputs(const ImDrawList* list, uint64_t version) noexcept
+    {
+        CachedInputs inputs{};
+        inputs.version_        = version;
+        inputs.pos_            = ImGui::GetCursorScreenPos();
+        inputs.avail_          = ImGui::GetContentRegionAvail();
+        inputs.clipMin_        = list->GetClipRectMin();
+        inputs.clipMax_        = list->GetClipRectMax();
+        inputs.font_           = ImGui::GetFont();
+        inputs.fontSize_       = ImGui::GetFontSize();
+        inputs.texture_        = ImGui::GetIO().Fonts->TexID;
+        inputs.fontGeneration_ = dear::detail::FontsGeneration();
+        return inputs;
+    }
+
+    // interacting is true if the widgets in the region may need to respond to input.
+    bool
+    interacting(const ImVec2& pos, const ImVec2& size) noexcept
+    {
+        if (ImGui::IsAnyItemActive() && ImGui::IsWindowFocused()) {
+            return true;
+        }
+        return ImGui::IsWindowHovered() &&
+               ImGui::IsMouseHoveringRect(pos, ImVec2(pos.x + size.x, pos.y + size.y));
+    }
+
+    // capture copies what was added to list since its buffers held vtxStart vertices,
+    // idxStart indices and cmdStart + 1 commands into out, so that it can be spliced back in
+    // with SpliceDrawCommands: indices are made relative to the first captured vertex.
+    // Returns true if out already held the same geometry.
+    bool
+    capture(ImDrawList& out, const ImDrawList& list, int vtxStart, int idxStart,
+            int cmdStart) noexcept
+    {
+        const int         vtxCount = list.VtxBuffer.Size - vtxStart;
+        const int         idxCount = list.IdxBuffer.Size - idxStart;
+        const ImDrawVert* vtx      = list.VtxBuffer.Data + vtxStart;
+        const size_t      vtxBytes = static_cast<size_t>(vtxCount) * sizeof(ImDrawVert);
+        bool unchanged = out.VtxBuffer.Size == vtxCount && out.IdxBuffer.Size == idxCount &&
+                         (vtxCount == 0 || memcmp(out.VtxBuffer.Data, vtx, vtxBytes) == 0);
+        if (!unchanged) {
+            out.VtxBuffer.resize(vtxCount);
+            out.IdxBuffer.resize(idxCount);
+            if (vtxCount > 0) {
+                (void) memcpy(out.VtxBuffer.Data, vtx, vtxBytes);
+            }
+        }
+
+        const auto firstVtx = static_cast<unsigned int>(vtxStart);
+        const auto firstIdx = static_cast<unsigned int>(idxStart);
+        int        cmdCount = 0;
+        for (int i = std::max(cmdStart, 0); i < list.CmdBuffer.Size; ++i) {
+            ImDrawCmd          cmd   = list.CmdBuffer[i];
+            const unsigned int begin = std::max(cmd.IdxOffset, firstIdx);
+            const unsigned int end   = cmd.IdxOffset + cmd.ElemCount;
+            if (end <= begin && (cmd.UserCallback == nullptr || i == cmdStart)) {
+                continue;
+            }
+            // Commands before the region may have a vertex offset below the first captured
+            // vertex; their indices get the difference taken off instead.
+            const unsigned int rebase = cmd.VtxOffset < firstVtx ? firstVtx - cmd.VtxOffset : 0;
+            for (unsigned int n = begin; n < end; ++n) {
+                const auto index = static_cast<ImDrawIdx>(list.IdxBuffer.Data[n] - rebase);
+                ImDrawIdx& dst   = out.IdxBuffer.Data[n - firstIdx];
+                unchanged        = unchanged && dst == index;
+                dst              = index;
+            }
+            cmd.VtxOffset = cmd.VtxOffset < firstVtx ? 0 : cmd.VtxOffset - firstVtx;
+            cmd.IdxOffset = begin - firstIdx;
+            cmd.ElemCount = end > begin ? end - begin : 0;
+            if (cmdCount < out.CmdBuffer.Size) {
+                unchanged = unchanged && same(out.CmdBuffer.Data[cmdCount], cmd);
+                out.CmdBuffer.Data[cmdCount] = cmd;
+            } else {
+                unchanged = false;
+                out.CmdBuffer.push_back(cmd);
+            }
+            ++cmdCount;
+        }
+        if (cmdCount != out.CmdBuffer.Size) {
+            unchanged = false;
+            out.CmdBuffer.resize(cmdCount);
+        }
+        return unchanged;
+    }
+
+}  // namespace
+
+namespace dear
+{
+    namespace detail
+    {
+        // CachedRecording lives in a Memo slot.
+        struct CachedRecording
+        {
+            ImDrawList   geometry_{nullptr};
+            CachedInputs inputs_{};
+            ImVec2       size_{};
+            float        baseline_{0.0F};   // text baseline offset of the group's last line
+            bool         recorded_{false};  // geometry_ was recorded with inputs_
+            bool         settled_{false};   // ... and was the same the time before
+
+            // While the callable runs.
+            ImDrawList* list_{nullptr};
+            int         vtxStart_{0};
+            int         idxStart_{0};
+            int         cmdStart_{0};
+            int         channel_{0};
+            int         windowsBegun_{0};
+        };
+
+        CachedRecording* CachedBegin(ImGuiID id, uint64_t version) noexcept
+        {
+            CachedRecording&   recording = MemoHold<CachedRecording>(MemoFind(id));
+            ImDrawList*        list      = ImGui::GetWindowDrawList();
+            const CachedInputs inputs    = currentInputs(list, version);
+
+            if (recording.settled_ && same(inputs, recording.inputs_) &&
+                !interacting(inputs.pos_, recording.size_)) {
+                SpliceDrawCommands(list, recording.geometry_);
+                // Reproduce the group rather than just its size, so that SameLine() and text
+                // after the region line up with it as they did when it ran.
+                ImGui::BeginGroup();
+                ImGui::GetCurrentWindow()->DC.CurrLineTextBaseOffset = recording.baseline_;
+                ImGui::Dummy(recording.size_);
+                ImGui::EndGroup();
+                return nullptr;
+            }
+
+            if (!same(inputs, recording.inputs_)) {
+                recording.recorded_ = false;
+            }
+            recording.inputs_       = inputs;
+            recording.list_         = list;
+            recording.vtxStart_     = list->VtxBuffer.Size;
+            recording.idxStart_     = list->IdxBuffer.Size;
+            recording.cmdStart_     = list->CmdBuffer.Size - 1;
+            recording.channel_      = list->_Splitter._Current;
+            recording.windowsBegun_ = ImGui::GetCurrentContext()->WindowsActiveCount;
+            ImGui::BeginGroup();
+            return &recording;
+        }
+
+        void CachedEnd(CachedRecording* recording) noexcept
+        {
+            // EndGroup aligns what follows with the baseline of the group's last line.
+            const float baseline = ImGui::GetCurrentWindow()->DC.PrevLineTextBaseOffset;
+            ImGui::EndGroup();
+            const ImVec2 size = ImGui::GetItemRectSize();
+
+            // Windows begun inside the region (child windows, scrolling tables, popups) draw
+            // into lists of their own, which aren't captured, so it is never replayed.
+            ImDrawList* list = recording->list_;
+            if (list != ImGui::GetWindowDrawList() ||
+                list->_Splitter._Current != recording->channel_ ||
+                ImGui::GetCurrentContext()->WindowsActiveCount != recording->windowsBegun_ ||
+                interacting(recording->inputs_.pos_, size)) {
+                recording->recorded_ = recording->settled_ = false;
+                return;
+            }
+
+            const bool unchanged = capture(recording->geometry_, *list, recording->vtxStart_,
+                                           recording->idxStart_, recording->cmdStart_);
+            recording->settled_ =
+                recording->recorded_ && unchanged && same(size, recording->size_);
+            recording->recorded_ = true;
+            recording->size_     = size;
+            recording->baseline_ = baseline;
+        }
+    }  // namespace detail
+}  // namespace dear
@@ -0,0 +1,84 @@
+#pragma once
+
+// dear::Cached keeps the geometry of a static region of a window across frames, and
+// replays it instead of running the region's widget code:
+//
+//   dear::Cached("legend", legend.Version()) && [&] {
+//       for (const Series& series : legend.series_) {
+//           ImGui::ColorButton(series.name_, series.color_);
+//           ImGui::SameLine();
+//           ImGui::TextUnformatted(series.name_);
+//       }
+//   };
+//
+// The region is laid out as a group. The first time, the callable runs and the vertices,
+// indices and draw commands it adds to the window's draw list are copied. On later frames,
+// if the version you supply and the region's layout inputs (its position, the space
+// available to it, the clip rect and the font) are all unchanged, the copy is spliced back
+// into the draw list and an empty group of the same size and text baseline takes its
+// place, without calling the callable.
+//
+// Anything the version doesn't capture is assumed not to change: the text, colors and
+// style of the content, and any state the widgets keep. ImGui sometimes takes a frame or
+// two to settle a layout (auto-fitting tables and windows), so a recording is only
+// replayed once the same inputs have produced the same geometry twice in a row.
+//
+// Widgets that aren't run can't be interacted with, so while the mouse is over the region,
+// or one of the window's items is active, the callable runs every frame and nothing is
+// recorded. Keyboard navigation into the region isn't detected. The callable must leave
+// the draw list in the channel it started in (don't start a cached region in one table
+// column and end it in another).
+//
+// Only the window's own draw list is recorded. A region that begins a window of its own (a
+// child window, a table with ImGuiTableFlags_ScrollX or ScrollY, a popup or a tooltip) is
+// never replayed: its callable simply runs every frame.
+//
+// Recordings are kept in dear::Memo's slots, keyed by ImGuiID, and are dropped after
+// ImGuiWrapConfig::memoEvictFrames_ frames without use.
+
+#include "imgui.h"
+#include "imguiwrap.dear.h"
+
+#include <cstdint>
+#include <utility>
+
+namespace dear
+{
+    namespace detail
+    {
+        struct CachedRecording;
+
+        // CachedBegin replays the recording for id and returns nullptr if it is current;
+        // otherwise it returns the recording, and the caller runs its callable and then
+        // calls CachedEnd.
+        extern CachedRecording* CachedBegin(ImGuiID id, uint64_t version) noexcept;
+        extern void             CachedEnd(CachedRecording* recording) noexcept;
+    }  // namespace detail
+
+    struct Cached : public ScopeWrapper<Cached, true>
+    {
+        Cached(const char* label, uint64_t version) noexcept
+            : ScopeWrapper(true, label), id_(ImGui::GetID(label)), version_(version)
+        {}
+        Cached(ImGuiID id, uint64_t version) noexcept
+            : ScopeWrapper(true, "Cached"), id_(id), version_(version)
+        {}
+
+        template<typename DrawFn>
+        bool operator&&(DrawFn&& draw) noexcept
+        {
+            detail::CachedRecording* recording = detail::CachedBegin(id_, version_);
+            if (recording != nullptr) {
+                std::forward<DrawFn>(draw)();
+                detail::CachedEnd(recording);
+            }
+            return true;
+        }
+
+        static void dtor() noexcept {}
+
+    private:
+        const ImGuiID  id_;
+        const uint64_t version_;
+    };
+}  // namespace dear
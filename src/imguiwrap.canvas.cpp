@@ -0,0 +1,220 @@
+#include "imguiwrap.canvas.h"
+
+#include "imgui_internal.h"  // ImDrawListSharedData::TexUvWhitePixel
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define IMGUIWRAP_CANVAS_SSE2
+#    include <emmintrin.h>
+#endif
+
+namespace
+{
+    // With 16-bit indices a single reservation can only address 64K vertices.
+    constexpr size_t MaxQuadsPerBatch =
+        sizeof(ImDrawIdx) == 2 ? (size_t{1} << 16U) / 4 - 1 : size_t{1} << 20U;
+
+    // Transform maps data to screen coordinates for two points at a time, as
+    // {x0, y0, x1, y1}. Bias is added after the transform.
+    class Transform
+    {
+    public:
+        Transform(ImVec2 origin, ImVec2 scale) noexcept
+#ifdef IMGUIWRAP_CANVAS_SSE2
+            : origin_(_mm_setr_ps(origin.x, origin.y, origin.x, origin.y))
+            , scale_(_mm_setr_ps(scale.x, scale.y, scale.x, scale.y))
+#else
+            : origin_(origin), scale_(scale)
+#endif
+        {}
+
+        // Pair transforms the two adjacent points at xyxy.
+        void Pair(const ImVec2* xyxy, float* out, const float* bias) const noexcept
+        {
+#ifdef IMGUIWRAP_CANVAS_SSE2
+            const __m128 in = _mm_loadu_ps(&xyxy->x);
+            _mm_storeu_ps(out, apply(in, bias));
+#else
+            apply(xyxy[0], xyxy[1], out, bias);
+#endif
+        }
+
+        // Single transforms one point into both halves of out.
+        void Single(const ImVec2* xy, float* out, const float* bias) const noexcept
+        {
+#ifdef IMGUIWRAP_CANVAS_SSE2
+            const __m128 half = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(xy));
+            _mm_storeu_ps(out, apply(_mm_movelh_ps(half, half), bias));
+#else
+            apply(*xy, *xy, out, bias);
+#endif
+        }
+
+    private:
+#ifdef IMGUIWRAP_CANVAS_SSE2
+        __m128 apply(__m128 in, const float* bias) const noexcept
+        {
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(in, scale_), origin_), _mm_loadu_ps(bias));
+        }
+
+        __m128 origin_;
+        __m128 scale_;
+#else
+        void apply(const ImVec2& a, const ImVec2& b, float* out, const float* bias) const noexcept
+        {
+            out[0] = a.x * scale_.x + origin_.x + bias[0];
+            out[1] = a.y * scale_.y + origin_.y + bias[1];
+            out[2] = b.x * scale_.x + origin_.x + bias[2];
+            out[3] = b.y * scale_.y + origin_.y + bias[3];
+        }
+
+        ImVec2 origin_;
+        ImVec2 scale_;
+#endif
+    };
+
+    // packColor is ImGui::ColorConvertFloat4ToU32, four channels at a time.
+    ImU32
+    packColor(const ImVec4& color) noexcept
+    {
+#ifdef IMGUIWRAP_CANVAS_SSE2
+        __m128 rgba = _mm_loadu_ps(&color.x);
+#    if IM_COL32_R_SHIFT != 0
+        rgba = _mm_shuffle_ps(rgba, rgba, _MM_SHUFFLE(3, 0, 1, 2));  // BGRA packing
+#    endif
+        rgba = _mm_min_ps(_mm_max_ps(rgba, _mm_setzero_ps()), _mm_set1_ps(1.0F));
+        const __m128i ints =
+            _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(rgba, _mm_set1_ps(255.0F)), _mm_set1_ps(0.5F)));
+        const __m128i words = _mm_packs_epi32(ints, ints);
+        return static_cast<ImU32>(_mm_cvtsi128_si32(_mm_packus_epi16(words, words)));
+#else
+        return ImGui::ColorConvertFloat4ToU32(color);
+#endif
+    }
+
+    // emitQuads reserves space for up to MaxQuadsPerBatch quads at a time, and has quadFn
+    // fill in the four corners of each, in the order ImDrawList::PrimRect uses.
+    template<typename ColorFn, typename QuadFn>
+    void
+    emitQuads(ImDrawList* list, size_t count, ColorFn&& colorFn, QuadFn&& quadFn) noexcept
+    {
+        const ImVec2 uv = list->_Data->TexUvWhitePixel;
+        for (size_t first = 0; first < count; first += MaxQuadsPerBatch) {
+            const size_t batch = std::min(count - first, MaxQuadsPerBatch);
+            list->PrimReserve(static_cast<int>(batch * 6), static_cast<int>(batch * 4));
+
+            ImDrawVert*  vtx  = list->_VtxWritePtr;
+            ImDrawIdx*   idx  = list->_IdxWritePtr;
+            unsigned int base = list->_VtxCurrentIdx;
+            ImVec2       pos[4];
+            for (size_t i = first; i < first + batch; ++i) {
+                quadFn(i, pos);
+                const ImU32 col = colorFn(i);
+                vtx[0]          = ImDrawVert{pos[0], uv, col};
+                vtx[1]          = ImDrawVert{pos[1], uv, col};
+                vtx[2]          = ImDrawVert{pos[2], uv, col};
+                vtx[3]          = ImDrawVert{pos[3], uv, col};
+                idx[0]          = static_cast<ImDrawIdx>(base);
+                idx[1]          = static_cast<ImDrawIdx>(base + 1);
+                idx[2]          = static_cast<ImDrawIdx>(base + 2);
+                idx[3]          = static_cast<ImDrawIdx>(base);
+                idx[4]          = static_cast<ImDrawIdx>(base + 2);
+                idx[5]          = static_cast<ImDrawIdx>(base + 3);
+                vtx += 4;
+                idx += 6;
+                base += 4;
+            }
+
+            list->_VtxWritePtr   = vtx;
+            list->_IdxWritePtr   = idx;
+            list->_VtxCurrentIdx = base;
+        }
+    }
+
+    // axisAligned fills in a quad from its min and max corners, as {x0, y0, x1, y1}.
+    void
+    axisAligned(const float* corners, ImVec2* pos) noexcept
+    {
+        pos[0] = ImVec2(corners[0], corners[1]);
+        pos[1] = ImVec2(corners[2], corners[1]);
+        pos[2] = ImVec2(corners[2], corners[3]);
+        pos[3] = ImVec2(corners[0], corners[3]);
+    }
+
+    // withColors calls emit with a color function for the kind of colors given, so the
+    // choice is made once per call rather than per primitive.
+    template<typename EmitFn>
+    void
+    withColors(const dear::CanvasColors& colors, EmitFn&& emit) noexcept
+    {
+        if (colors.floats_ != nullptr) {
+            const ImVec4* floats = colors.floats_;
+            emit([floats](size_t i) { return packColor(floats[i]); });
+        } else if (colors.packed_ != nullptr) {
+            const ImU32* packed = colors.packed_;
+            emit([packed](size_t i) { return packed[i]; });
+        } else {
+            const ImU32 uniform = colors.uniform_;
+            emit([uniform](size_t) { return uniform; });
+        }
+    }
+
+}  // namespace
+
+namespace dear
+{
+    void CanvasBatch::Points(const ImVec2* points, size_t count, float size,
+                             CanvasColors colors) noexcept
+    {
+        const Transform transform(origin_, scale_);
+        const float     half    = size * 0.5F;
+        const float     bias[4] = {-half, -half, half, half};
+        withColors(colors, [&](auto&& colorFn) {
+            emitQuads(list_, count, colorFn, [&](size_t i, ImVec2* pos) {
+                float corners[4];
+                transform.Single(&points[i], corners, bias);
+                axisAligned(corners, pos);
+            });
+        });
+    }
+
+    void CanvasBatch::Segments(const ImVec2* endpoints, size_t count, float thickness,
+                               CanvasColors colors) noexcept
+    {
+        const Transform transform(origin_, scale_);
+        const float     half    = thickness * 0.5F;
+        const float     bias[4] = {0.0F, 0.0F, 0.0F, 0.0F};
+        withColors(colors, [&](auto&& colorFn) {
+            emitQuads(list_, count, colorFn, [&](size_t i, ImVec2* pos) {
+                float ends[4];
+                transform.Pair(&endpoints[i * 2], ends, bias);
+                // Offset both ends by half the thickness along the segment's normal.
+                const float dx       = ends[2] - ends[0];
+                const float dy       = ends[3] - ends[1];
+                const float lengthSq = dx * dx + dy * dy;
+                const float scale    = lengthSq > 0.0F ? half / std::sqrt(lengthSq) : 0.0F;
+                const float nx       = -dy * scale;
+                const float ny       = dx * scale;
+                pos[0]               = ImVec2(ends[0] + nx, ends[1] + ny);
+                pos[1]               = ImVec2(ends[2] + nx, ends[3] + ny);
+                pos[2]               = ImVec2(ends[2] - nx, ends[3] - ny);
+                pos[3]               = ImVec2(ends[0] - nx, ends[1] - ny);
+            });
+        });
+    }
+
+    void CanvasBatch::Rects(const ImVec2* corners, size_t count, CanvasColors colors) noexcept
+    {
+        const Transform transform(origin_, scale_);
+        const float     bias[4] = {0.0F, 0.0F, 0.0F, 0.0F};
+        withColors(colors, [&](auto&& colorFn) {
+            emitQuads(list_, count, colorFn, [&](size_t i, ImVec2* pos) {
+                float rect[4];
+                transform.Pair(&corners[i * 2], rect, bias);
+                axisAligned(rect, pos);
+            });
+        });
+    }
+}  // namespace dear
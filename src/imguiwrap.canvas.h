@@ -0,0 +1,101 @@
+#pragma once
+
+// dear::Canvas draws arrays of simple primitives into a draw list in bulk.
+//
+// Calling ImDrawList::AddRectFilled and friends once per element means a reservation, a
+// command check and a handful of function calls per primitive, which dominates when
+// plotting hundreds of thousands of points. Canvas takes arrays of positions (and
+// optionally colors), maps them from data to screen coordinates, and writes the vertices
+// and indices for a whole batch after a single reservation, using SSE2 for the transform
+// and for packing float colors where available.
+//
+// Primitives are solid quads, without anti-aliasing, using the font atlas' white pixel,
+// so they can be mixed freely with regular ImDrawList calls. Unlike ImDrawList, fully
+// transparent primitives are not skipped.
+//
+// dear::Canvas is a scope, like the other dear:: wrappers, which hands its callable a
+// CanvasBatch to draw with. In dear::ParallelCanvas chunks, which run on worker threads,
+// construct a CanvasBatch on the chunk's draw list directly instead.
+
+#include "imgui.h"
+#include "imguiwrap.dear.h"
+
+#include <cstddef>
+#include <utility>
+
+namespace dear
+{
+    // CanvasColors is either a single color for all primitives, or one per primitive as
+    // packed ImU32s or float ImVec4s.
+    struct CanvasColors
+    {
+        CanvasColors(ImU32 color) noexcept : uniform_(color) {}         // NOLINT
+        CanvasColors(const ImU32* colors) noexcept : packed_(colors) {}  // NOLINT
+        CanvasColors(const ImVec4* colors) noexcept : floats_(colors) {} // NOLINT
+
+        ImU32         uniform_{0};
+        const ImU32*  packed_{nullptr};
+        const ImVec4* floats_{nullptr};
+    };
+
+    // CanvasBatch writes primitives into a draw list, mapping data coordinates to screen
+    // coordinates as origin + position * scale.
+    class CanvasBatch
+    {
+    public:
+        CanvasBatch(ImDrawList* list, ImVec2 origin = ImVec2(0.0F, 0.0F),
+                    ImVec2 scale = ImVec2(1.0F, 1.0F)) noexcept
+            : list_(list), origin_(origin), scale_(scale)
+        {}
+
+        // Points draws a size x size pixel square centered on each of count points.
+        void Points(const ImVec2* points, size_t count, float size, CanvasColors colors) noexcept;
+
+        // Segments draws count lines, from endpoints[2i] to endpoints[2i + 1], thickness
+        // pixels wide.
+        void Segments(const ImVec2* endpoints, size_t count, float thickness,
+                      CanvasColors colors) noexcept;
+
+        // Rects fills count rectangles, with opposite corners corners[2i] and corners[2i + 1].
+        void Rects(const ImVec2* corners, size_t count, CanvasColors colors) noexcept;
+
+    private:
+        ImDrawList* list_;
+        ImVec2      origin_;
+        ImVec2      scale_;
+    };
+
+    // Canvas draws into the current window's draw list (or the one you pass in):
+    //
+    //   dear::Canvas(ImGui::GetCursorScreenPos(), ImVec2(zoom, -zoom)) &&
+    //       [&](dear::CanvasBatch& batch) {
+    //           batch.Segments(edges.data(), edges.size() / 2, 1.0F, IM_COL32(128, 128, 128, 255));
+    //           batch.Points(nodes.data(), nodes.size(), 3.0F, nodeColors.data());
+    //       };
+    struct Canvas : public ScopeWrapper<Canvas, true>
+    {
+        explicit Canvas(ImVec2 origin = ImVec2(0.0F, 0.0F),
+                        ImVec2 scale  = ImVec2(1.0F, 1.0F)) noexcept
+            : Canvas(ImGui::GetWindowDrawList(), origin, scale)
+        {}
+        Canvas(ImDrawList* list, ImVec2 origin = ImVec2(0.0F, 0.0F),
+               ImVec2 scale = ImVec2(1.0F, 1.0F)) noexcept
+            : ScopeWrapper(true, "Canvas"), list_(list), origin_(origin), scale_(scale)
+        {}
+
+        template<typename DrawFn>
+        bool operator&&(DrawFn&& draw) noexcept
+        {
+            CanvasBatch batch(list_, origin_, scale_);
+            std::forward<DrawFn>(draw)(batch);
+            return true;
+        }
+
+        static void dtor() noexcept {}
+
+    private:
+        ImDrawList* const list_;
+        const ImVec2      origin_;
+        const ImVec2      scale_;
+    };
+}  // namespace dear
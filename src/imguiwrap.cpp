@@ -12,9 +12,22 @@
 #include "imgui_impl_opengl3_loader.h"
 #include <GLFW/glfw3.h>
 
+#include "imguiwrap.alloc.h"
 #include "imguiwrap.dear.h"
+#include "imguiwrap.drawcost.h"
+#include "imguiwrap.drawmerge.h"
+#include "imguiwrap.fonts.h"
 #include "imguiwrap.h"
 #include "imguiwrap.helpers.h"
+#include "imguiwrap.latency.h"
+#include "imguiwrap.memo.h"
+#include "imguiwrap.memory.h"
+#include "imguiwrap.parallelcanvas.h"
+#include "imguiwrap.profile.h"
+#include "imguiwrap.published.h"
+#include "imguiwrap.settings.h"
+#include "imguiwrap.streamtexture.h"
+#include "imguiwrap.task.h"
 
 #include "imgui_internal.h"
 
@@ -74,6 +87,19 @@ imgui_main(const ImGuiWrapConfig& config, const ImGuiWrapperFn& mainFn) noexcept
 
     // Setup Dear ImGui context
     IMGUI_CHECKVERSION();
+    // The allocator has to be in place before the context makes its first allocation.
+    if (config.poolAllocator_) {
+        dear::detail::InstallPoolAllocator(config.poolHugePages_);
+    }
+#ifdef IMGUIWRAP_ALLOC_CHECKER
+    else if (config.allocCheckWarmupFrames_ > 0) {
+        // The checker needs to see ImGui's own allocations too.
+        dear::detail::InstallCountingAllocator();
+    }
+    if (config.allocCheckWarmupFrames_ > 0) {
+        dear::detail::AllocCheckStart(config.allocCheckWarmupFrames_, config.allocCheckAssert_);
+    }
+#endif
     ImGui::CreateContext();
     if (config.keyboardNav_) {
         ImGui::GetIO().ConfigFlags |=
@@ -101,16 +127,48 @@ imgui_main(const ImGuiWrapConfig& config, const ImGuiWrapperFn& mainFn) noexcept
 		ImGui::StyleColorsLight();
 	}
 
+    dear::detail::MemoryStart(config.compactAfterSeconds_, config.releaseIdleSeconds_);
+
+    if (config.fontCount_ > 0) {
+        dear::detail::FontsLoad(ImGui::GetIO().Fonts, config.fonts_, config.fontCount_,
+                                config.dynamicGlyphs_);
+    }
+
+    // The latency callbacks go in first so that the GLFW backend chains to them.
+    if (config.measureLatency_ || config.lowLatency_) {
+        dear::detail::LatencyStart(window, config.enableVsync_, config.lowLatency_,
+                                   config.lowLatencyMarginMs_);
+    }
+
     // Setup Platform/Renderer backends
     /// TODO: Needs to be based on cmake config.
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init(glsl_version);
 
+    if (config.asyncSettings_) {
+        if (config.settingsPath_ != nullptr) {
+            dear::detail::SettingsStart(config.settingsPath_);
+        } else {
+            ImGui::GetIO().IniFilename = nullptr;
+        }
+    }
+
     // Main loop
     const auto&        clearColor = config.clearColor_;
     std::optional<int> exitCode{};
 
     while (!exitCode.has_value() && glfwWindowShouldClose(window) == 0) {
+        dear::detail::AllocatorFrameBoundary();
+#ifdef IMGUIWRAP_ALLOC_CHECKER
+        dear::detail::AllocCheckFrameBegin();
+#endif
+#ifdef IMGUIWRAP_PROFILING
+        dear::detail::ProfileFrameBegin();
+#endif
+#ifdef IMGUIWRAP_DRAW_COST
+        dear::detail::DrawCostFrameBegin();
+#endif
+
         // Poll and handle events (inputs, window resize, etc.)
         // You can read the io.WantCaptureMouse, io.WantCaptureKeyboard flags to tell if dear imgui
         // wants to use your inputs.
@@ -119,7 +177,10 @@ imgui_main(const ImGuiWrapConfig& config, const ImGuiWrapperFn& mainFn) noexcept
         // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main
         // application. Generally you may always pass all inputs to dear imgui, and hide them from
         // your application based on those two flags.
-        glfwPollEvents();
+        dear::detail::LatencyPollEvents(window);
+
+        // take the newest snapshots from dear::Published, to be read for the whole frame.
+        dear::detail::PublishedFrameBegin();
 
         // Start the Dear ImGui frame
         ImGui_ImplOpenGL3_NewFrame();
@@ -128,8 +189,21 @@ imgui_main(const ImGuiWrapConfig& config, const ImGuiWrapperFn& mainFn) noexcept
 
         exitCode = mainFn();
 
+#ifdef IMGUIWRAP_COROUTINES
+        // Resume suspended tasks while ImGui still accepts widgets for this frame.
+        dear::detail::TasksRun(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<float, std::milli>(config.taskBudgetMs_)));
+#endif
+
         // Rendering
         ImGui::Render();
+        const bool rebuildFonts = dear::detail::FontsScan();
+        dear::detail::SettingsFrameEnd();
+        dear::detail::MemoFrameEnd(config.memoEvictFrames_);
+        dear::detail::MemoryFrameEnd();
+        if (config.mergeDrawCommands_) {
+            (void) dear::OptimizeDrawData(ImGui::GetDrawData());
+        }
 
         // NOLINTNEXTLINE(readability-isolate-declaration) input parameters to next call.
         int display_w{0}, display_h{0};
@@ -141,11 +215,14 @@ imgui_main(const ImGuiWrapConfig& config, const ImGuiWrapperFn& mainFn) noexcept
                      clearColor.z * clearColor.w, clearColor.w);
         glClear(GL_COLOR_BUFFER_BIT);
 
+        // upload the newest frames published to dear::StreamTextures, so they are drawn.
+        dear::detail::StreamTexturesUpload();
+
         // finialize the imgui render into draw data, and render it.
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
         // swap the render/draw buffers so the user can see this frame.
-        glfwSwapBuffers(window);
+        dear::detail::LatencySwapBuffers(window);
 
 #ifdef IMGUI_HAS_VIEWPORT
 		// Update and Render additional Platform Windows
@@ -155,17 +232,51 @@ imgui_main(const ImGuiWrapConfig& config, const ImGuiWrapperFn& mainFn) noexcept
 		}
 #endif
 
+        // add glyphs that were drawn for the first time (ImGuiWrapConfig::dynamicGlyphs_).
+        if (rebuildFonts) {
+            dear::detail::FontsRebuild();
+            ImGui_ImplOpenGL3_DestroyFontsTexture();
+            (void) ImGui_ImplOpenGL3_CreateFontsTexture();
+        }
+
         // change the native (host) window size if requested.
         if (newSize.has_value()) {
             glfwSetWindowSize(window, newSize.value().first, newSize.value().second);
             newSize.reset();
         }
+
+#ifdef IMGUIWRAP_ALLOC_CHECKER
+        dear::detail::AllocCheckFrameEnd();
+#endif
+#ifdef IMGUIWRAP_PROFILING
+        dear::detail::ProfileFrameEnd();
+#endif
+#ifdef IMGUIWRAP_DRAW_COST
+        dear::detail::DrawCostFrameEnd();
+#endif
     }
 
+#ifdef IMGUIWRAP_ALLOC_CHECKER
+    dear::detail::AllocCheckStop();
+#endif
+#ifdef IMGUIWRAP_PROFILING
+    dear::detail::ProfileStop();
+#endif
+
     // Cleanup
+#ifdef IMGUIWRAP_COROUTINES
+    dear::detail::TasksShutdown();
+#endif
+    dear::detail::SettingsStop();
+    dear::detail::MemoClear();
+    dear::detail::MemoryStop();
+    dear::detail::CanvasShutdown();
+    dear::detail::LatencyStop();
+    dear::detail::StreamTexturesStop();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
+    dear::detail::FontsStop();
 
     glfwDestroyWindow(window);
     glfwTerminate();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <type_traits>
 #include <utility>  // std::forward etc
 
 #include "imgui.h"
@@ -9,11 +10,57 @@
 #endif
 
 #include "imguiwrap.helpers.h"
+#include "imguiwrap.id.h"
+
+namespace ImGui
+{
+    // Declared in imgui_internal.h; used by dear::WithID to push precomputed IDs.
+    IMGUI_API void PushOverrideID(ImGuiID id);
+}  // namespace ImGui
+
+// Instrumented builds (see the IMGUIWRAP_ALLOC_CHECKER, IMGUIWRAP_PROFILING and
+// IMGUIWRAP_DRAW_COST options in src/CMakeLists.txt) need the dear:: scopes to report their
+// labels as they are entered and left.
+#if (defined(IMGUIWRAP_ALLOC_CHECKER) || defined(IMGUIWRAP_PROFILING) || \
+     defined(IMGUIWRAP_DRAW_COST)) &&                                     \
+    !defined(IMGUIWRAP_SCOPE_HOOKS)
+#    define IMGUIWRAP_SCOPE_HOOKS
+#endif
 
 namespace dear
 {
     static const ImVec2 Zero(0.0f, 0.0f);
 
+    namespace detail
+    {
+        // ScopeLabel picks the first argument as a scope's label if it is a string,
+        // otherwise the supplied fallback (e.g. for TreeNode(ptr_id, fmt, ...)).
+        template<typename First, typename... Rest>
+        constexpr const char* ScopeLabel(const char* fallback, const First& first,
+                                         const Rest&... /*rest*/) noexcept
+        {
+            if constexpr (std::is_convertible_v<const First&, const char*>) {
+                return first;
+            } else {
+                return fallback;
+            }
+        }
+
+#ifdef IMGUIWRAP_SCOPE_HOOKS
+        // ScopeEnter/ScopeExit maintain a per-thread stack of active scope labels.
+        // A null label is a transparent scope (e.g. WithStyleVar).
+        extern void ScopeEnter(const char* label) noexcept;
+        extern void ScopeExit() noexcept;
+
+        // CurrentScopeLabel returns the innermost named scope, or nullptr.
+        extern const char* CurrentScopeLabel() noexcept;
+
+        // FormatScopePath writes the '/'-separated path of named scopes into buffer,
+        // keeping the innermost labels if it doesn't fit, and returns the length.
+        extern size_t FormatScopePath(char* buffer, size_t bufferSize) noexcept;
+#endif
+    }  // namespace detail
+
     // EditTableFlags provides a window with checkboxes/selects for all of the
     // ImGuiTableFlags options so that a flags property can be edited in real-time.
     extern void
@@ -54,16 +101,30 @@ namespace dear
         // constructor takes a predicate that may be used to determine if
         // additional calls can be made, and a function/lambda/callable to
         // be invoked from the destructor.
-        constexpr ScopeWrapper(bool ok) noexcept : ok_{ok} {}
+        // The label is only used by instrumented builds (IMGUIWRAP_SCOPE_HOOKS).
+#ifdef IMGUIWRAP_SCOPE_HOOKS
+        ScopeWrapper(bool ok, const char* label = nullptr) noexcept : ok_{enter(label) && ok} {}
+#else
+        constexpr ScopeWrapper(bool ok, const char* /*label*/ = nullptr) noexcept : ok_{ok} {}
+#endif
+
+        // Wrappers around a Begin call pass it as a callable instead, so that instrumented
+        // builds enter the scope before it runs and its cost is attributed to the scope.
+        template<typename BeginFn,
+                 typename = std::enable_if_t<std::is_invocable_r_v<bool, BeginFn&&>>>
+        ScopeWrapper(const char* label, BeginFn&& begin) noexcept
+            : ok_{enter(label) && std::forward<BeginFn>(begin)()}
+        {}
 
         // destructor always invokes the supplied destructor function.
         ~ScopeWrapper() noexcept
         {
-            if constexpr (!force_dtor) {
-                if (!ok_)
-                    return;
-            }
-            Base::dtor();
+            if (force_dtor || ok_)
+                Base::dtor();
+#ifdef IMGUIWRAP_SCOPE_HOOKS
+            // After dtor, so that e.g. EndTable's layout work counts towards the table.
+            detail::ScopeExit();
+#endif
         }
 
         // operator&& will excute 'code' if the predicate supplied during
@@ -81,6 +142,18 @@ namespace dear
     protected:
         ScopeWrapper(const ScopeWrapper&) = delete;
         ScopeWrapper& operator=(const ScopeWrapper&) = delete;
+
+    private:
+        // enter reports the scope to the hooks, and is always true.
+#ifdef IMGUIWRAP_SCOPE_HOOKS
+        static bool enter(const char* label) noexcept
+        {
+            detail::ScopeEnter(label);
+            return true;
+        }
+#else
+        static constexpr bool enter(const char* /*label*/) noexcept { return true; }
+#endif
     };
 
     // Wrapper for ImGui::Begin ... End, which will always call End.
@@ -88,7 +161,7 @@ namespace dear
     {
         // Invoke Begin and guarantee that 'End' will be called.
         Begin(const char* title, bool* open = nullptr, ImGuiWindowFlags flags = 0) noexcept
-            : ScopeWrapper(ImGui::Begin(title, open, flags))
+            : ScopeWrapper(title, [&] { return ImGui::Begin(title, open, flags); })
         {}
         static void dtor() noexcept { ImGui::End(); }
     };
@@ -98,11 +171,11 @@ namespace dear
     {
         Child(const char* title, const ImVec2& size = Zero, bool border = false,
               ImGuiWindowFlags flags = 0) noexcept
-            : ScopeWrapper(ImGui::BeginChild(title, size, border, flags))
+            : ScopeWrapper(title, [&] { return ImGui::BeginChild(title, size, border, flags); })
         {}
         Child(ImGuiID id, const ImVec2& size = Zero, bool border = false,
               ImGuiWindowFlags flags = 0) noexcept
-            : ScopeWrapper(ImGui::BeginChild(id, size, border, flags))
+            : ScopeWrapper("Child", [&] { return ImGui::BeginChild(id, size, border, flags); })
         {}
         static void dtor() noexcept { ImGui::EndChild(); }
     };
@@ -112,7 +185,8 @@ namespace dear
     {
         template<typename... Args>
         ChildFrame(Args&&... args) noexcept
-            : ScopeWrapper(ImGui::BeginChildFrame(std::forward<Args>(args)...))
+            : ScopeWrapper("ChildFrame",
+                           [&] { return ImGui::BeginChildFrame(std::forward<Args>(args)...); })
         {}
         static void dtor() noexcept { ImGui::EndChildFrame(); }
     };
@@ -120,7 +194,7 @@ namespace dear
     // Wrapper for ImGui::BeginGroup ... EndGroup which will always call EndGroup.
     struct Group : public ScopeWrapper<Group, true>
     {
-        Group() noexcept : ScopeWrapper(true) { ImGui::BeginGroup(); }
+        Group() noexcept : ScopeWrapper(true, "Group") { ImGui::BeginGroup(); }
         static void dtor() noexcept { ImGui::EndGroup(); }
     };
 
@@ -128,7 +202,7 @@ namespace dear
     struct Combo : public ScopeWrapper<Combo>
     {
         Combo(const char* label, const char* preview, ImGuiComboFlags flags = 0) noexcept
-            : ScopeWrapper(ImGui::BeginCombo(label, preview, flags))
+            : ScopeWrapper(label, [&] { return ImGui::BeginCombo(label, preview, flags); })
         {}
         static void dtor() noexcept { ImGui::EndCombo(); }
     };
@@ -137,7 +211,7 @@ namespace dear
     struct ListBox : public ScopeWrapper<ListBox>
     {
         ListBox(const char* label, const ImVec2& size = Zero) noexcept
-            : ScopeWrapper(ImGui::BeginListBox(label, size))
+            : ScopeWrapper(label, [&] { return ImGui::BeginListBox(label, size); })
         {}
         static void dtor() noexcept { ImGui::EndListBox(); }
     };
@@ -145,14 +219,16 @@ namespace dear
     // Wrapper for ImGui::Begin...EndMenuBar.
     struct MenuBar : public ScopeWrapper<MenuBar>
     {
-        MenuBar() noexcept : ScopeWrapper(ImGui::BeginMenuBar()) {}
+        MenuBar() noexcept : ScopeWrapper("MenuBar", [] { return ImGui::BeginMenuBar(); }) {}
         static void dtor() noexcept { ImGui::EndMenuBar(); }
     };
 
     // Wrapper for ImGui::Begin...EndMainMenuBar.
     struct MainMenuBar : public ScopeWrapper<MainMenuBar>
     {
-        MainMenuBar() noexcept : ScopeWrapper(ImGui::BeginMainMenuBar()) {}
+        MainMenuBar() noexcept
+            : ScopeWrapper("MainMenuBar", [] { return ImGui::BeginMainMenuBar(); })
+        {}
         static void dtor() noexcept { ImGui::EndMainMenuBar(); }
     };
 
@@ -160,7 +236,7 @@ namespace dear
     struct Menu : public ScopeWrapper<Menu>
     {
         Menu(const char* label, bool enabled = true) noexcept
-            : ScopeWrapper(ImGui::BeginMenu(label, enabled))
+            : ScopeWrapper(label, [&] { return ImGui::BeginMenu(label, enabled); })
         {}
         static void dtor() noexcept { ImGui::EndMenu(); }
     };
@@ -171,7 +247,9 @@ namespace dear
     {
         Table(const char* str_id, int column, ImGuiTableFlags flags = 0,
               const ImVec2& outer_size = Zero, float inner_width = 0.0f) noexcept
-            : ScopeWrapper(ImGui::BeginTable(str_id, column, flags, outer_size, inner_width))
+            : ScopeWrapper(str_id, [&] {
+                return ImGui::BeginTable(str_id, column, flags, outer_size, inner_width);
+            })
         {}
         static void dtor() noexcept { ImGui::EndTable(); }
     };
@@ -179,7 +257,7 @@ namespace dear
     // Wrapper for ImGui::Begin...EndToolTip.
     struct Tooltip : public ScopeWrapper<Tooltip>
     {
-        Tooltip() noexcept : ScopeWrapper(true) { ImGui::BeginTooltip(); }
+        Tooltip() noexcept : ScopeWrapper(true, "Tooltip") { ImGui::BeginTooltip(); }
         static void dtor() noexcept { ImGui::EndTooltip(); }
     };
 
@@ -187,7 +265,7 @@ namespace dear
     struct CollapsingHeader : public ScopeWrapper<CollapsingHeader>
     {
         CollapsingHeader(const char* label, ImGuiTreeNodeFlags flags = 0) noexcept
-            : ScopeWrapper(ImGui::CollapsingHeader(label, flags))
+            : ScopeWrapper(label, [&] { return ImGui::CollapsingHeader(label, flags); })
         {}
         inline static void dtor() noexcept {}
     };
@@ -198,7 +276,8 @@ namespace dear
     {
         template<typename... Args>
         TreeNode(Args&&... args) noexcept
-            : ScopeWrapper(ImGui::TreeNode(std::forward<Args>(args)...))
+            : ScopeWrapper(detail::ScopeLabel("TreeNode", args...),
+                           [&] { return ImGui::TreeNode(std::forward<Args>(args)...); })
         {}
         static void dtor() noexcept { ImGui::TreePop(); }
     };
@@ -208,7 +287,8 @@ namespace dear
     {
         template<typename... Args>
         SeparatedTreeNode(Args&&... args) noexcept
-            : ScopeWrapper(ImGui::TreeNode(std::forward<Args>(args)...))
+            : ScopeWrapper(detail::ScopeLabel("TreeNode", args...),
+                           [&] { return ImGui::TreeNode(std::forward<Args>(args)...); })
         {}
         static void dtor() noexcept
         {
@@ -224,7 +304,7 @@ namespace dear
     {
         // Non-modal Popup.
         Popup(const char* str_id, ImGuiWindowFlags flags = 0) noexcept
-            : ScopeWrapper(ImGui::BeginPopup(str_id, flags))
+            : ScopeWrapper(str_id, [&] { return ImGui::BeginPopup(str_id, flags); })
         {}
 
         // Modal popups.
@@ -238,7 +318,7 @@ namespace dear
         {
         };
         Popup(modal, const char* name, bool* p_open = nullptr, ImGuiWindowFlags flags = 0) noexcept
-            : ScopeWrapper(ImGui::BeginPopupModal(name, p_open, flags))
+            : ScopeWrapper(name, [&] { return ImGui::BeginPopupModal(name, p_open, flags); })
         {}
 
         static Popup
@@ -254,7 +334,7 @@ namespace dear
     struct PopupModal : public ScopeWrapper<PopupModal>
     {
         PopupModal(const char* name, bool* p_open = nullptr, ImGuiWindowFlags flags = 0) noexcept
-            : ScopeWrapper(ImGui::BeginPopupModal(name, p_open, flags))
+            : ScopeWrapper(name, [&] { return ImGui::BeginPopupModal(name, p_open, flags); })
         {}
         static void dtor() noexcept { ImGui::EndPopup(); }
     };
@@ -263,7 +343,7 @@ namespace dear
     struct TabBar : public ScopeWrapper<TabBar>
     {
         TabBar(const char* name, ImGuiTabBarFlags flags = 0) noexcept
-            : ScopeWrapper(ImGui::BeginTabBar(name, flags))
+            : ScopeWrapper(name, [&] { return ImGui::BeginTabBar(name, flags); })
         {}
         static void dtor() noexcept { ImGui::EndTabBar(); }
     };
@@ -272,7 +352,7 @@ namespace dear
     struct TabItem : public ScopeWrapper<TabItem>
     {
         TabItem(const char* name, bool* open = nullptr, ImGuiTabItemFlags flags = 0) noexcept
-            : ScopeWrapper(ImGui::BeginTabItem(name, open, flags))
+            : ScopeWrapper(name, [&] { return ImGui::BeginTabItem(name, open, flags); })
         {}
         static void dtor() noexcept { ImGui::EndTabItem(); }
     };
@@ -292,13 +372,48 @@ namespace dear
         static void dtor() noexcept { ImGui::PopStyleVar(); }
     };
 
+    // WithID pushes onto ImGui's ID stack for the duration of the scope.
+    //
+    // In loops over thousands of rows, prefer the int overload to formatting and hashing a
+    // string per row, or a precomputed dear::ID (see imguiwrap.id.h), which is pushed as-is
+    // without any hashing. A precomputed ID replaces the whole chain, so it has to be seeded
+    // from the enclosing window/ID scope to collide with nothing else.
+    struct WithID : public ScopeWrapper<WithID>
+    {
+        WithID(const char* str_id) noexcept : ScopeWrapper(true) { ImGui::PushID(str_id); }
+        WithID(const void* ptr_id) noexcept : ScopeWrapper(true) { ImGui::PushID(ptr_id); }
+        WithID(int int_id) noexcept : ScopeWrapper(true) { ImGui::PushID(int_id); }
+        WithID(ID id) noexcept : ScopeWrapper(true) { ImGui::PushOverrideID(id); }
+#ifndef DEAR_NO_STRING
+        WithID(const std::string& str_id) noexcept : ScopeWrapper(true)
+        {
+            ImGui::PushID(str_id.c_str(), str_id.c_str() + str_id.size());
+        }
+#endif
+        // A raw ImGuiID is ambiguous: use dear::ID{id} to push it as-is, or cast to int.
+        WithID(ImGuiID id) = delete;
+
+        static void dtor() noexcept { ImGui::PopID(); }
+    };
+
+    // Zone marks a region of your own code for profiling builds (the IMGUIWRAP_PROFILING
+    // cmake option, see imguiwrap.profile.h), alongside the dear:: scopes. The name should
+    // be a string literal or otherwise outlive the zone. In other builds it does nothing.
+    //
+    //   dear::Zone("Relayout") && [&] { graph.Relayout(); };
+    struct Zone : public ScopeWrapper<Zone, true>
+    {
+        Zone(const char* name) noexcept : ScopeWrapper(true, name) {}
+        static void dtor() noexcept {}
+    };
+
     /// TODO: WithStyleColor
 
     // Wrapper for BeginTooltip predicated on the previous item being hovered.
     struct ItemTooltip : public ScopeWrapper<ItemTooltip>
     {
         ItemTooltip(ImGuiHoveredFlags flags = 0) noexcept
-            : ScopeWrapper(ImGui::IsItemHovered(flags))
+            : ScopeWrapper("Tooltip", [&] { return ImGui::IsItemHovered(flags); })
         {
             if (ok_)
                 ImGui::BeginTooltip();
@@ -0,0 +1,357 @@
+// Per-scope draw cost: the geometry each labelled dear:: scope adds to its draw list,
+// aggregated by label.
+//
+// Only built when the IMGUIWRAP_DRAW_COST cmake option is on; see imguiwrap.drawcost.h.
+
+#include "imguiwrap.drawcost.h"
+#include "imguiwrap.dear.h"
+
+#include "imgui_internal.h"  // ImHashStr, ImGuiContext
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifndef IMGUIWRAP_DRAW_COST
+#    error "imguiwrap.drawcost.cpp requires IMGUIWRAP_DRAW_COST"
+#endif
+
+namespace
+{
+    // Scopes nested deeper than this are still balanced, but not measured.
+    constexpr size_t MaxDepth = 64;
+
+    enum Column
+    {
+        ScopeColumn,
+        CallsColumn,
+        VerticesColumn,
+        SelfVerticesColumn,
+        IndicesColumn,
+        CommandsColumn,
+        PeakVerticesColumn,
+        ColumnCount,
+    };
+
+    struct Counts
+    {
+        int64_t vertices_{0};
+        int64_t indices_{0};
+        int64_t commands_{0};
+    };
+
+    Counts
+    operator-(const Counts& lhs, const Counts& rhs) noexcept
+    {
+        return Counts{lhs.vertices_ - rhs.vertices_, lhs.indices_ - rhs.indices_,
+                      lhs.commands_ - rhs.commands_};
+    }
+
+    Counts&
+    operator+=(Counts& lhs, const Counts& rhs) noexcept
+    {
+        lhs.vertices_ += rhs.vertices_;
+        lhs.indices_ += rhs.indices_;
+        lhs.commands_ += rhs.commands_;
+        return lhs;
+    }
+
+    // Tables park the index and command buffers of the columns they aren't drawing, so
+    // those two counts drop and rise as a scope crosses cells; never go negative.
+    Counts
+    clamped(const Counts& counts) noexcept
+    {
+        return Counts{std::max<int64_t>(counts.vertices_, 0),
+                      std::max<int64_t>(counts.indices_, 0),
+                      std::max<int64_t>(counts.commands_, 0)};
+    }
+
+    Counts
+    countsOf(const ImDrawList* list) noexcept
+    {
+        return Counts{list->VtxBuffer.Size, list->IdxBuffer.Size, list->CmdBuffer.Size};
+    }
+
+    // windowCounts totals the draw lists of the windows whose first Begin this frame came
+    // after 'since' Begins, other than 'skip'. A window's draw list is cleared by its first
+    // Begin in a frame, so all of it was drawn since then.
+    Counts
+    windowCounts(const ImGuiContext& g, int since, const ImDrawList* skip) noexcept
+    {
+        Counts counts{};
+        for (const ImGuiWindow* window : g.Windows) {
+            if (window->LastFrameActive == g.FrameCount &&
+                window->BeginOrderWithinContext >= since && window->DrawList != skip) {
+                counts += countsOf(window->DrawList);
+            }
+        }
+        return counts;
+    }
+
+    // CostEntry accumulates everything measured for one label.
+    struct CostEntry
+    {
+        std::string name_;
+
+        // The current frame so far.
+        Counts   frame_{};
+        int64_t  frameSelfVertices_{0};
+        uint64_t frameCalls_{0};
+        bool     touched_{false};
+
+        // Totals over the frames the label was seen in.
+        Counts   total_{};
+        int64_t  totalSelfVertices_{0};
+        uint64_t calls_{0};
+        uint64_t frames_{0};
+        int64_t  peakVertices_{0};
+    };
+
+    struct OpenScope
+    {
+        CostEntry*        entry_{nullptr};  // null: not measured
+        const ImDrawList* list_{nullptr};   // null: no current window
+        Counts            start_{};
+        int               windowsBegun_{0};   // g.WindowsActiveCount on entry
+        int64_t           childVertices_{0};  // added by nested scopes
+    };
+
+    // CostState is only touched from the UI thread.
+    struct CostState
+    {
+        // unordered_map nodes are stable, so open scopes can point at entries.
+        std::unordered_map<ImGuiID, CostEntry> entries_;
+        std::vector<CostEntry*>                touched_;
+        std::vector<const CostEntry*>          sorted_;
+        std::array<OpenScope, MaxDepth>        stack_{};
+        size_t                                 depth_{0};
+        bool                                   showing_{false};
+    };
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    CostState costState;
+
+    // uiThread is only set on the thread running imgui_main; draw lists belong to it.
+    thread_local bool uiThread{false};
+
+    double
+    perFrame(int64_t value, const CostEntry& entry) noexcept
+    {
+        return entry.frames_ > 0 ? static_cast<double>(value) / static_cast<double>(entry.frames_)
+                                 : 0.0;
+    }
+
+    double
+    columnValue(const CostEntry& entry, int column) noexcept
+    {
+        switch (column) {
+        case CallsColumn:
+            return perFrame(static_cast<int64_t>(entry.calls_), entry);
+        case VerticesColumn:
+            return perFrame(entry.total_.vertices_, entry);
+        case SelfVerticesColumn:
+            return perFrame(entry.totalSelfVertices_, entry);
+        case IndicesColumn:
+            return perFrame(entry.total_.indices_, entry);
+        case CommandsColumn:
+            return perFrame(entry.total_.commands_, entry);
+        case PeakVerticesColumn:
+            return static_cast<double>(entry.peakVertices_);
+        default:
+            return 0.0;
+        }
+    }
+
+    void
+    sortEntries(const ImGuiTableSortSpecs* specs) noexcept
+    {
+        auto& sorted = costState.sorted_;
+        sorted.clear();
+        for (const auto& [id, entry] : costState.entries_) {
+            if (entry.frames_ > 0) {
+                sorted.push_back(&entry);
+            }
+        }
+        const auto before = [specs](const CostEntry* lhs, const CostEntry* rhs) noexcept {
+            for (int i = 0; specs != nullptr && i < specs->SpecsCount; ++i) {
+                const ImGuiTableColumnSortSpecs& spec = specs->Specs[i];
+                const bool ascending = spec.SortDirection == ImGuiSortDirection_Ascending;
+                if (spec.ColumnIndex == ScopeColumn) {
+                    if (lhs->name_ != rhs->name_) {
+                        return ascending == (lhs->name_ < rhs->name_);
+                    }
+                    continue;
+                }
+                const double left  = columnValue(*lhs, spec.ColumnIndex);
+                const double right = columnValue(*rhs, spec.ColumnIndex);
+                if (left != right) {
+                    return ascending == (left < right);
+                }
+            }
+            return lhs->name_ < rhs->name_;
+        };
+        std::sort(sorted.begin(), sorted.end(), before);
+    }
+
+}  // namespace
+
+namespace dear
+{
+    void ShowDrawCostWindow(bool* open) noexcept
+    {
+        // The window's own scopes aren't interesting.
+        costState.showing_ = true;
+        ImGui::SetNextWindowSize(ImVec2(640.0F, 400.0F), ImGuiCond_FirstUseEver);
+        Begin("Draw cost", open) && [] {
+            if (ImGui::Button("Reset")) {
+                ResetDrawCost();
+            }
+            ImGui::SameLine();
+            ImGui::TextUnformatted("Per-frame averages; \"self\" excludes nested scopes.");
+
+            constexpr ImGuiTableFlags flags =
+                ImGuiTableFlags_Sortable | ImGuiTableFlags_SortMulti | ImGuiTableFlags_RowBg |
+                ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY;
+            Table("costs", ColumnCount, flags) && [] {
+                constexpr ImGuiTableColumnFlags numeric =
+                    ImGuiTableColumnFlags_PreferSortDescending | ImGuiTableColumnFlags_WidthFixed;
+                ImGui::TableSetupScrollFreeze(0, 1);
+                ImGui::TableSetupColumn("Scope", ImGuiTableColumnFlags_WidthStretch);
+                ImGui::TableSetupColumn("Calls", numeric);
+                ImGui::TableSetupColumn("Vertices", numeric | ImGuiTableColumnFlags_DefaultSort);
+                ImGui::TableSetupColumn("Self vertices", numeric);
+                ImGui::TableSetupColumn("Indices", numeric);
+                ImGui::TableSetupColumn("Commands", numeric);
+                ImGui::TableSetupColumn("Peak vertices", numeric);
+                ImGui::TableHeadersRow();
+
+                // Values change every frame, so re-sort every frame regardless of SpecsDirty.
+                ImGuiTableSortSpecs* specs = ImGui::TableGetSortSpecs();
+                sortEntries(specs);
+                if (specs != nullptr) {
+                    specs->SpecsDirty = false;
+                }
+
+                ImGuiListClipper clipper;
+                clipper.Begin(static_cast<int>(costState.sorted_.size()));
+                while (clipper.Step()) {
+                    for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                        const CostEntry& entry = *costState.sorted_[static_cast<size_t>(row)];
+                        ImGui::TableNextRow();
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(entry.name_.c_str());
+                        for (int column = CallsColumn; column < ColumnCount; ++column) {
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%.1f", columnValue(entry, column));
+                        }
+                    }
+                }
+            };
+        };
+        costState.showing_ = false;
+    }
+
+    void ResetDrawCost() noexcept
+    {
+        // Scopes that are open right now keep pointing at their entries.
+        for (auto& [id, entry] : costState.entries_) {
+            const std::string name = std::move(entry.name_);
+            entry                  = CostEntry{};
+            entry.name_            = name;
+        }
+        costState.touched_.clear();
+    }
+
+    namespace detail
+    {
+        void DrawCostEnter(const char* label) noexcept
+        {
+            if (!uiThread) {
+                return;
+            }
+            CostState& state = costState;
+            if (state.depth_ < MaxDepth) {
+                OpenScope&          scope = state.stack_[state.depth_];
+                const ImGuiContext* g     = ImGui::GetCurrentContext();
+                scope                     = OpenScope{};
+                if (label != nullptr && !state.showing_ && g != nullptr) {
+                    CostEntry& entry = state.entries_[ImHashStr(label)];
+                    if (entry.name_.empty()) {
+                        entry.name_ = label;
+                    }
+                    // Sampled before the scope's Begin call, which may draw into the
+                    // current window (BeginTable, TreeNode) or begin a window of its own.
+                    scope.entry_        = &entry;
+                    scope.windowsBegun_ = g->WindowsActiveCount;
+                    if (g->CurrentWindow != nullptr) {
+                        scope.list_  = g->CurrentWindow->DrawList;
+                        scope.start_ = countsOf(scope.list_);
+                    }
+                }
+            }
+            ++state.depth_;
+        }
+
+        void DrawCostExit() noexcept
+        {
+            if (!uiThread || costState.depth_ == 0) {
+                return;
+            }
+            CostState& state = costState;
+            --state.depth_;
+            if (state.depth_ >= MaxDepth || state.stack_[state.depth_].entry_ == nullptr) {
+                return;
+            }
+
+            const OpenScope&    scope = state.stack_[state.depth_];
+            const ImGuiContext& g     = *ImGui::GetCurrentContext();
+            Counts delta = scope.list_ != nullptr ? clamped(countsOf(scope.list_) - scope.start_)
+                                                  : Counts{};
+            // Child windows, popups, tooltips and scrolling tables draw into lists of
+            // their own.
+            if (g.WindowsActiveCount != scope.windowsBegun_) {
+                delta += windowCounts(g, scope.windowsBegun_, scope.list_);
+            }
+            CostEntry& entry = *scope.entry_;
+            entry.frame_ += delta;
+            entry.frameSelfVertices_ +=
+                std::max<int64_t>(delta.vertices_ - scope.childVertices_, 0);
+            ++entry.frameCalls_;
+            if (!entry.touched_) {
+                entry.touched_ = true;
+                state.touched_.push_back(&entry);
+            }
+
+            // Let the innermost measured scope know, since its delta includes this one's.
+            for (size_t i = std::min(state.depth_, MaxDepth); i > 0; --i) {
+                OpenScope& parent = state.stack_[i - 1];
+                if (parent.entry_ != nullptr) {
+                    parent.childVertices_ += delta.vertices_;
+                    break;
+                }
+            }
+        }
+
+        void DrawCostFrameBegin() noexcept { uiThread = true; }
+
+        void DrawCostFrameEnd() noexcept
+        {
+            for (CostEntry* entry : costState.touched_) {
+                entry->total_ += entry->frame_;
+                entry->totalSelfVertices_ += entry->frameSelfVertices_;
+                entry->calls_ += entry->frameCalls_;
+                entry->peakVertices_ = std::max(entry->peakVertices_, entry->frame_.vertices_);
+                ++entry->frames_;
+
+                entry->frame_             = Counts{};
+                entry->frameSelfVertices_ = 0;
+                entry->frameCalls_        = 0;
+                entry->touched_           = false;
+            }
+            costState.touched_.clear();
+        }
+    }  // namespace detail
+}  // namespace dear
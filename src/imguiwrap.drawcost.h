@@ -0,0 +1,48 @@
+#pragma once
+
+// Per-scope draw cost, built with the IMGUIWRAP_DRAW_COST cmake option.
+//
+// In these builds every labelled dear:: scope notes the vertex, index and command counts
+// of the window draw list it is drawing into when it is entered (before its Begin call),
+// and again when it is left, adding the draw lists of any windows begun inside it: its
+// own window for dear::Begin, and child windows, popups, tooltips and scrolling tables.
+// The differences are aggregated by label across frames, so you can see which windows,
+// tables or tree nodes are responsible for most of the geometry:
+//
+//   dear::ShowDrawCostWindow(&showDrawCost);
+//
+// Costs are inclusive of nested scopes; "self" columns exclude them. Only scopes entered
+// on the thread running imgui_main are measured; a dear::Zone outside any window only
+// counts the windows begun inside it.
+//
+// Vertex counts are exact. Tables move the indices and commands of the columns they are
+// not currently drawing out of the draw list, so a scope that spans several cells of a
+// table (but not the table itself) under-reports those two counts.
+
+#ifdef IMGUIWRAP_DRAW_COST
+
+#    include <cstdint>
+
+namespace dear
+{
+    // ShowDrawCostWindow draws a window with a table of scope labels by their average
+    // per-frame geometry, sortable by any column.
+    extern void ShowDrawCostWindow(bool* open = nullptr) noexcept;
+
+    // ResetDrawCost discards everything measured so far.
+    extern void ResetDrawCost() noexcept;
+
+    namespace detail
+    {
+        // DrawCostEnter/DrawCostExit are called by the scope hooks (see ScopeEnter); null
+        // labels are transparent.
+        extern void DrawCostEnter(const char* label) noexcept;
+        extern void DrawCostExit() noexcept;
+
+        // imgui_main brackets each frame with these.
+        extern void DrawCostFrameBegin() noexcept;
+        extern void DrawCostFrameEnd() noexcept;
+    }  // namespace detail
+}  // namespace dear
+
+#endif  // IMGUIWRAP_DRAW_COST
@@ -0,0 +1,126 @@
+#include "imguiwrap.drawmerge.h"
+
+#include <algorithm>
+
+namespace
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    dear::DrawMergeStats lastStats{};
+
+    bool
+    sameRect(const ImVec4& lhs, const ImVec4& rhs) noexcept
+    {
+        return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z && lhs.w == rhs.w;
+    }
+
+    // Renderers truncate clip rects to whole framebuffer pixels when setting the scissor, so
+    // geometry is only treated as unclipped if it stays this far inside its clip rect.
+    float
+    clipMargin(const ImDrawData* drawData) noexcept
+    {
+        const float scale = std::min(drawData->FramebufferScale.x, drawData->FramebufferScale.y);
+        return 2.0F / std::min(1.0F, scale > 0.0F ? scale : 1.0F);
+    }
+
+    // fitsClipRect checks whether every vertex a command draws lies inside its clip rect,
+    // less the margin, i.e. the clip rect doesn't actually clip anything.
+    bool
+    fitsClipRect(const ImDrawList* list, const ImDrawCmd& cmd, float margin) noexcept
+    {
+        const ImVec4&     clip = cmd.ClipRect;
+        const ImDrawIdx*  idx  = list->IdxBuffer.Data + cmd.IdxOffset;
+        const ImDrawVert* vtx  = list->VtxBuffer.Data + cmd.VtxOffset;
+        for (unsigned int i = 0; i < cmd.ElemCount; ++i) {
+            const ImVec2& pos = vtx[idx[i]].pos;
+            if (pos.x < clip.x + margin || pos.y < clip.y + margin || pos.x > clip.z - margin ||
+                pos.y > clip.w - margin) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool
+    invisible(const ImDrawCmd& cmd, const ImVec4& display) noexcept
+    {
+        const ImVec4& clip = cmd.ClipRect;
+        return cmd.ElemCount == 0 || clip.z <= clip.x || clip.w <= clip.y ||
+               clip.x >= display.z || clip.y >= display.w || clip.z <= display.x ||
+               clip.w <= display.y;
+    }
+
+    void
+    optimizeList(ImDrawList* list, const ImVec4& display, float margin,
+                 dear::DrawMergeStats& stats) noexcept
+    {
+        ImVector<ImDrawCmd>& cmds = list->CmdBuffer;
+        stats.commandsBefore_ += cmds.Size;
+
+        // For the last command kept: -1 if we don't yet know whether it fits its clip rect.
+        int lastFits = -1;
+        int kept     = 0;
+        for (int i = 0; i < cmds.Size; ++i) {
+            const ImDrawCmd cmd = cmds[i];
+            if (cmd.UserCallback == nullptr && invisible(cmd, display)) {
+                ++stats.dropped_;
+                continue;
+            }
+
+            if (kept > 0) {
+                ImDrawCmd& last = cmds[kept - 1];
+                const bool compatible =
+                    last.UserCallback == nullptr && cmd.UserCallback == nullptr &&
+                    last.TextureId == cmd.TextureId && last.VtxOffset == cmd.VtxOffset &&
+                    last.IdxOffset + last.ElemCount == cmd.IdxOffset;
+                if (compatible && sameRect(last.ClipRect, cmd.ClipRect)) {
+                    last.ElemCount += cmd.ElemCount;
+                    lastFits = lastFits == 0 ? 0 : -1;
+                    ++stats.merged_;
+                    continue;
+                }
+                if (compatible) {
+                    if (lastFits < 0) {
+                        lastFits = fitsClipRect(list, last, margin) ? 1 : 0;
+                    }
+                    if (lastFits == 1 && fitsClipRect(list, cmd, margin)) {
+                        last.ClipRect = ImVec4(std::min(last.ClipRect.x, cmd.ClipRect.x),
+                                               std::min(last.ClipRect.y, cmd.ClipRect.y),
+                                               std::max(last.ClipRect.z, cmd.ClipRect.z),
+                                               std::max(last.ClipRect.w, cmd.ClipRect.w));
+                        last.ElemCount += cmd.ElemCount;
+                        ++stats.merged_;
+                        continue;
+                    }
+                }
+            }
+
+            cmds[kept++] = cmd;
+            lastFits     = -1;
+        }
+
+        cmds.resize(kept);
+        stats.commandsAfter_ += kept;
+    }
+
+}  // namespace
+
+namespace dear
+{
+    DrawMergeStats OptimizeDrawData(ImDrawData* drawData) noexcept
+    {
+        DrawMergeStats stats{};
+        if (drawData != nullptr && drawData->Valid) {
+            const ImVec4 display(drawData->DisplayPos.x, drawData->DisplayPos.y,
+                                 drawData->DisplayPos.x + drawData->DisplaySize.x,
+                                 drawData->DisplayPos.y + drawData->DisplaySize.y);
+            const float  margin = clipMargin(drawData);
+            for (int n = 0; n < drawData->CmdListsCount; ++n) {
+                optimizeList(drawData->CmdLists[n], display, margin, stats);
+            }
+        }
+        lastStats = stats;
+        return stats;
+    }
+
+    DrawMergeStats GetDrawMergeStats() noexcept { return lastStats; }
+}  // namespace dear
@@ -0,0 +1,38 @@
+#pragma once
+
+// Draw-command merge pass.
+//
+// ImGui starts a new ImDrawCmd whenever the clip rect or texture changes, so UIs with many
+// child windows, table cells or columns produce lots of small commands, each of which costs
+// a draw call in the renderer backend. OptimizeDrawData rewrites the command lists of a
+// frame's ImDrawData, after ImGui::Render, so that:
+//
+// - commands with no elements, or whose clip rect is empty or entirely off-screen, are
+//   dropped,
+// - adjacent commands with the same texture and vertex offset and contiguous indices are
+//   merged, if their clip rects are identical, or if neither command's geometry actually
+//   reaches the edges of its clip rect (in which case the union of the two is used),
+//
+// so the rendered pixels are unchanged. Commands with user callbacks are never touched.
+//
+// imgui_main runs the pass when ImGuiWrapConfig::mergeDrawCommands_ is set.
+
+#include "imgui.h"
+
+namespace dear
+{
+    // DrawMergeStats describes the effect of the last OptimizeDrawData call.
+    struct DrawMergeStats
+    {
+        int commandsBefore_{0};
+        int commandsAfter_{0};
+        int dropped_{0};
+        int merged_{0};
+    };
+
+    // OptimizeDrawData merges and drops commands in place, and returns what it did.
+    extern DrawMergeStats OptimizeDrawData(ImDrawData* drawData) noexcept;
+
+    // GetDrawMergeStats returns the result of the last OptimizeDrawData call.
+    extern DrawMergeStats GetDrawMergeStats() noexcept;
+}  // namespace dear
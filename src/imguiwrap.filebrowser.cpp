@@ -0,0 +1,790 @@
+#include "imguiwrap.filebrowser.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cfloat>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#if defined(_WIN32)
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <cwchar>
+#    include <windows.h>
+#else
+#    include <cerrno>
+#    include <dirent.h>
+#    include <fcntl.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace dear
+{
+    namespace detail
+    {
+        // FileStat is what a stat worker found out about one entry.
+        struct FileStat
+        {
+            uint32_t index_{0};
+            uint64_t size_{0};
+            int64_t  modified_{0};
+            bool     directory_{false};
+            bool     valid_{false};  // the stat succeeded; otherwise keep what listing found
+        };
+
+        // StatJob is a batch of entries for a stat worker, starting at entry index first_.
+        struct StatJob
+        {
+            uint32_t                 first_{0};
+            std::vector<std::string> names_;
+        };
+
+        // FileListing is shared between a FileBrowser and the threads listing its directory,
+        // and freed by whichever lets go of it last.
+        struct FileListing
+        {
+            explicit FileListing(std::string path) noexcept : path_(std::move(path)) {}
+
+            const std::string path_;
+            std::atomic<bool> cancel_{false};
+
+            std::mutex              mutex_;
+            std::condition_variable wake_;  // for stat workers: there are jobs, or no more
+
+            // For the UI.
+            std::vector<FileEntry> listed_;
+            std::vector<FileStat>  statted_;
+            std::string            error_;
+            bool                   enumerated_{false};
+            size_t                 unstatted_{0};  // entries listed but not yet statted
+
+            std::deque<StatJob> jobs_;
+        };
+    }  // namespace detail
+}  // namespace dear
+
+namespace
+{
+    using dear::FileEntry;
+    using dear::detail::FileListing;
+    using dear::detail::FileStat;
+    using dear::detail::StatJob;
+    using Clock = std::chrono::steady_clock;
+
+    // Entries are handed to the UI in batches that start small, so the first ones show up
+    // straight away, and double up to MaxBatch; a batch is also handed over once it is
+    // FlushInterval old, in case listing is slow.
+    constexpr size_t FirstBatch    = 256;
+    constexpr size_t MaxBatch      = 8192;
+    constexpr auto   FlushInterval = std::chrono::milliseconds(10);
+
+    // How many entries are filtered, sorted and merged into the view at a time: Update
+    // sizes chunks from the time the last one took, to fit several into the frame budget.
+    // Every merge copies the whole view, so a chunk is never smaller than 1/ViewShare of
+    // it, or the copying would dominate.
+    constexpr size_t MinChunk       = 256;
+    constexpr size_t MaxChunk       = 16384;
+    constexpr size_t ViewShare      = 128;
+    constexpr int    ChunksPerFrame = 4;
+
+    // Where an entry is, in FileBrowser::place_.
+    enum Place : uint8_t
+    {
+        Filtered = 0,  // doesn't match the filter
+        Pending  = 1,  // in pending_
+        InView   = 2,  // in view_
+    };
+
+    constexpr char
+    lower(char c) noexcept
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    bool
+    containsNoCase(const std::string& haystack, const std::string& needle) noexcept
+    {
+        const auto it = std::search(haystack.begin(), haystack.end(), needle.begin(), needle.end(),
+                                    [](char h, char n) { return lower(h) == n; });
+        return it != haystack.end();
+    }
+
+    // compareNames orders names case-insensitively, then by their bytes.
+    int
+    compareNames(const std::string& lhs, const std::string& rhs) noexcept
+    {
+        const size_t length = std::min(lhs.size(), rhs.size());
+        for (size_t i = 0; i < length; ++i) {
+            const char l = lower(lhs[i]), r = lower(rhs[i]);
+            if (l != r) {
+                return static_cast<unsigned char>(l) < static_cast<unsigned char>(r) ? -1 : 1;
+            }
+        }
+        if (lhs.size() != rhs.size()) {
+            return lhs.size() < rhs.size() ? -1 : 1;
+        }
+        return lhs.compare(rhs);
+    }
+
+    bool
+    isSeparator(char c) noexcept
+    {
+#if defined(_WIN32)
+        return c == '/' || c == '\\';
+#else
+        return c == '/';
+#endif
+    }
+
+    std::string
+    childPath(const std::string& path, const std::string& name)
+    {
+        if (path.empty() || isSeparator(path.back())) {
+            return path + name;
+        }
+        return path + '/' + name;
+    }
+
+    std::string
+    parentPath(std::string path)
+    {
+        while (path.size() > 1 && isSeparator(path.back())) {
+            path.pop_back();
+        }
+        size_t slash = path.size();
+        while (slash > 0 && !isSeparator(path[slash - 1])) {
+            --slash;
+        }
+        const std::string last = path.substr(slash);
+        if (last == "." || last == "..") {
+            return path + "/..";
+        }
+        if (slash == 0) {
+            return last.empty() ? path : ".";
+        }
+        // Keep the separator of a root: "/", or "C:\" on Windows.
+        const bool root = slash == 1 || (slash == 3 && path[1] == ':');
+        path.resize(root ? slash : slash - 1);
+        return path;
+    }
+
+    void
+    formatSize(char* text, size_t size, uint64_t bytes) noexcept
+    {
+        constexpr std::array<const char*, 4> units{"KB", "MB", "GB", "TB"};
+        if (bytes < 1024) {
+            (void) snprintf(text, size, "%llu B", static_cast<unsigned long long>(bytes));
+            return;
+        }
+        auto   value = static_cast<double>(bytes) / 1024.0;
+        size_t unit  = 0;
+        while (value >= 1024.0 && unit + 1 < units.size()) {
+            value /= 1024.0;
+            ++unit;
+        }
+        (void) snprintf(text, size, "%.1f %s", value, units[unit]);
+    }
+
+    void
+    formatTime(char* text, size_t size, int64_t seconds) noexcept
+    {
+        const auto time = static_cast<time_t>(seconds);
+        struct tm  local
+        {};
+#if defined(_WIN32)
+        (void) localtime_s(&local, &time);
+#else
+        (void) localtime_r(&time, &local);
+#endif
+        (void) strftime(text, size, "%Y-%m-%d %H:%M", &local);
+    }
+
+    // Batcher collects listed entries and hands them to the UI (and the stat workers).
+    class Batcher
+    {
+    public:
+        Batcher(FileListing& listing, bool statEntries) noexcept
+            : listing_(listing), statEntries_(statEntries)
+        {}
+
+        void Add(FileEntry&& entry) noexcept
+        {
+            if (statEntries_) {
+                job_.names_.push_back(entry.name_);
+            }
+            batch_.push_back(std::move(entry));
+            // Only look at the clock every so often.
+            if (batch_.size() >= limit_ || (batch_.size() % 64 == 0 && Clock::now() >= due_)) {
+                Flush();
+            }
+        }
+
+        void Flush() noexcept
+        {
+            if (!batch_.empty()) {
+                const std::lock_guard<std::mutex> lock(listing_.mutex_);
+                std::move(batch_.begin(), batch_.end(), std::back_inserter(listing_.listed_));
+                if (statEntries_) {
+                    listing_.unstatted_ += job_.names_.size();
+                    job_.first_ = next_;
+                    listing_.jobs_.push_back(std::move(job_));
+                    listing_.wake_.notify_one();
+                }
+                next_ += static_cast<uint32_t>(batch_.size());
+            }
+            batch_.clear();
+            job_   = StatJob{};
+            limit_ = std::min(limit_ * 2, MaxBatch);
+            due_   = Clock::now() + FlushInterval;
+        }
+
+    private:
+        FileListing&           listing_;
+        const bool             statEntries_;
+        std::vector<FileEntry> batch_;
+        StatJob                job_;
+        uint32_t               next_{0};
+        size_t                 limit_{FirstBatch};
+        Clock::time_point      due_{Clock::now() + FlushInterval};
+    };
+
+    void
+    finishListing(FileListing& listing, std::string error) noexcept
+    {
+        const std::lock_guard<std::mutex> lock(listing.mutex_);
+        listing.error_      = std::move(error);
+        listing.enumerated_ = true;
+        listing.wake_.notify_all();
+    }
+
+#if defined(_WIN32)
+
+    // The find API returns sizes and times with the names, so there is nothing to stat.
+    constexpr bool ListingNeedsStat = false;
+
+    int64_t
+    unixSeconds(const FILETIME& time) noexcept
+    {
+        // FILETIMEs count 100ns intervals since 1601.
+        constexpr int64_t EpochDifference = 116444736000000000LL;
+        const uint64_t ticks =
+            (static_cast<uint64_t>(time.dwHighDateTime) << 32U) | time.dwLowDateTime;
+        return (static_cast<int64_t>(ticks) - EpochDifference) / 10000000;
+    }
+
+    // widen and narrow convert between the UTF-8 paths FileBrowser uses and the UTF-16
+    // the wide Windows API takes; the ANSI API would mangle anything outside the code page.
+    std::wstring
+    widen(const std::string& text)
+    {
+        const int size = static_cast<int>(text.size());
+        const int wide = MultiByteToWideChar(CP_UTF8, 0, text.data(), size, nullptr, 0);
+        std::wstring result(static_cast<size_t>(wide), L'\0');
+        if (wide > 0) {
+            (void) MultiByteToWideChar(CP_UTF8, 0, text.data(), size, result.data(), wide);
+        }
+        return result;
+    }
+
+    std::string
+    narrow(const wchar_t* text)
+    {
+        const int bytes = WideCharToMultiByte(CP_UTF8, 0, text, -1, nullptr, 0, nullptr, nullptr);
+        if (bytes <= 1) {
+            return {};
+        }
+        std::string result(static_cast<size_t>(bytes), '\0');
+        (void) WideCharToMultiByte(CP_UTF8, 0, text, -1, result.data(), bytes, nullptr, nullptr);
+        result.pop_back();  // the terminator
+        return result;
+    }
+
+    void
+    listDirectory(FileListing& listing) noexcept
+    {
+        const std::wstring pattern = widen(childPath(listing.path_, "*"));
+        WIN32_FIND_DATAW   data{};
+        HANDLE find = FindFirstFileExW(pattern.c_str(), FindExInfoBasic, &data,
+                                       FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+        if (find == INVALID_HANDLE_VALUE) {
+            char error[64];
+            (void) snprintf(error, sizeof(error), "can't list directory (error %lu)",
+                            GetLastError());
+            finishListing(listing, error);
+            return;
+        }
+        Batcher batcher(listing, ListingNeedsStat);
+        do {
+            if (wcscmp(data.cFileName, L".") == 0 || wcscmp(data.cFileName, L"..") == 0) {
+                continue;
+            }
+            FileEntry entry;
+            entry.name_      = narrow(data.cFileName);
+            entry.size_ = (static_cast<uint64_t>(data.nFileSizeHigh) << 32U) | data.nFileSizeLow;
+            entry.modified_  = unixSeconds(data.ftLastWriteTime);
+            entry.directory_ = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+            entry.statted_   = true;
+            batcher.Add(std::move(entry));
+        } while (!listing.cancel_.load(std::memory_order_relaxed) &&
+                 FindNextFileW(find, &data) != 0);
+        FindClose(find);
+        batcher.Flush();
+        finishListing(listing, {});
+    }
+
+    void
+    statEntries(FileListing& /*listing*/) noexcept
+    {}
+
+#else
+
+    constexpr bool ListingNeedsStat = true;
+
+    // strerror isn't thread-safe, and listing runs on a thread of its own. glibc's
+    // strerror_r returns the message (GNU), others fill in the buffer and return 0 (XSI).
+    [[maybe_unused]] const char*
+    errorText(const char* message, const char* /*buffer*/) noexcept
+    {
+        return message;
+    }
+
+    [[maybe_unused]] const char*
+    errorText(int result, const char* buffer) noexcept
+    {
+        return result == 0 ? buffer : "unknown error";
+    }
+
+    void
+    listDirectory(FileListing& listing) noexcept
+    {
+        DIR* dir = ::opendir(listing.path_.c_str());
+        if (dir == nullptr) {
+            char buffer[128];
+            finishListing(listing, errorText(strerror_r(errno, buffer, sizeof(buffer)), buffer));
+            return;
+        }
+        Batcher batcher(listing, ListingNeedsStat);
+        while (!listing.cancel_.load(std::memory_order_relaxed)) {
+            const dirent* found = ::readdir(dir);
+            if (found == nullptr) {
+                break;
+            }
+            if (strcmp(found->d_name, ".") == 0 || strcmp(found->d_name, "..") == 0) {
+                continue;
+            }
+            FileEntry entry;
+            entry.name_ = found->d_name;
+            // Symbolic links (and DT_UNKNOWN) are resolved by the stat.
+            entry.directory_ = found->d_type == DT_DIR;
+            batcher.Add(std::move(entry));
+        }
+        ::closedir(dir);
+        batcher.Flush();
+        finishListing(listing, {});
+    }
+
+    // statEntries takes batches of entries to stat until the directory has been listed.
+    void
+    statEntries(FileListing& listing) noexcept
+    {
+        const int dirFd = ::open(listing.path_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        std::vector<FileStat> results;
+        for (;;) {
+            StatJob job;
+            {
+                std::unique_lock<std::mutex> lock(listing.mutex_);
+                listing.wake_.wait(lock, [&listing] {
+                    return listing.cancel_.load(std::memory_order_relaxed) ||
+                           !listing.jobs_.empty() || listing.enumerated_;
+                });
+                if (listing.cancel_.load(std::memory_order_relaxed) || listing.jobs_.empty()) {
+                    break;
+                }
+                job = std::move(listing.jobs_.front());
+                listing.jobs_.pop_front();
+            }
+
+            // A batch can take a while on a slow file system; stop as soon as the browser
+            // has moved on.
+            results.clear();
+            for (size_t i = 0; i < job.names_.size(); ++i) {
+                if (listing.cancel_.load(std::memory_order_relaxed)) {
+                    break;
+                }
+                FileStat    stat;
+                struct stat info
+                {};
+                stat.index_ = job.first_ + static_cast<uint32_t>(i);
+                // Follow symbolic links, but still show broken ones.
+                if (dirFd >= 0 && (::fstatat(dirFd, job.names_[i].c_str(), &info, 0) == 0 ||
+                                   ::fstatat(dirFd, job.names_[i].c_str(), &info,
+                                             AT_SYMLINK_NOFOLLOW) == 0)) {
+                    stat.size_      = static_cast<uint64_t>(info.st_size);
+                    stat.modified_  = static_cast<int64_t>(info.st_mtime);
+                    stat.directory_ = S_ISDIR(info.st_mode);
+                    stat.valid_     = true;
+                }
+                results.push_back(stat);
+            }
+
+            const std::lock_guard<std::mutex> lock(listing.mutex_);
+            std::copy(results.begin(), results.end(), std::back_inserter(listing.statted_));
+            listing.unstatted_ -= job.names_.size();
+        }
+        if (dirFd >= 0) {
+            ::close(dirFd);
+        }
+    }
+
+#endif
+
+    // StatThreads is how many threads stat entries, if they need it.
+    unsigned int
+    statThreads() noexcept
+    {
+        if (!ListingNeedsStat) {
+            return 0;
+        }
+        return std::clamp(std::thread::hardware_concurrency() / 2, 1U, 4U);
+    }
+}  // namespace
+
+namespace dear
+{
+    FileBrowser::FileBrowser(const char* path) noexcept { Open(path); }
+
+    FileBrowser::~FileBrowser() { stop(); }
+
+    // stop tells the listing's threads to give up, without waiting for them: they hold on
+    // to the listing until they notice, so a slow directory can't stall the UI thread.
+    void FileBrowser::stop() noexcept
+    {
+        if (listing_ != nullptr) {
+            const std::lock_guard<std::mutex> lock(listing_->mutex_);
+            listing_->cancel_.store(true, std::memory_order_relaxed);
+            listing_->wake_.notify_all();
+        }
+        listing_.reset();
+    }
+
+    void FileBrowser::Open(const char* path) noexcept
+    {
+        stop();
+        path_ = path;
+        entries_.clear();
+        place_.clear();
+        view_.clear();
+        pending_.clear();
+        error_.clear();
+        selected_ = -1;
+        listed_   = false;
+
+        listing_ = std::make_shared<detail::FileListing>(path_);
+        std::thread([listing = listing_] { listDirectory(*listing); }).detach();
+        for (unsigned int i = 0; i < statThreads(); ++i) {
+            std::thread([listing = listing_] { statEntries(*listing); }).detach();
+        }
+    }
+
+    bool FileBrowser::Listing() const noexcept { return listing_ != nullptr && !listed_; }
+
+    const FileEntry* FileBrowser::Selected() const noexcept
+    {
+        return selected_ >= 0 ? &entries_[static_cast<size_t>(selected_)] : nullptr;
+    }
+
+    std::string FileBrowser::SelectedPath() const noexcept
+    {
+        const FileEntry* entry = Selected();
+        return entry != nullptr ? childPath(path_, entry->name_) : std::string{};
+    }
+
+    bool FileBrowser::matches(const FileEntry& entry) const noexcept
+    {
+        return filter_.empty() || containsNoCase(entry.name_, filter_);
+    }
+
+    bool FileBrowser::before(uint32_t lhs, uint32_t rhs) const noexcept
+    {
+        const FileEntry& l = entries_[lhs];
+        const FileEntry& r = entries_[rhs];
+        if (l.directory_ != r.directory_) {
+            return l.directory_;
+        }
+        int order = 0;
+        if (sortBy_ == SortBy::Size && l.size_ != r.size_) {
+            order = l.size_ < r.size_ ? -1 : 1;
+        } else if (sortBy_ == SortBy::Modified && l.modified_ != r.modified_) {
+            order = l.modified_ < r.modified_ ? -1 : 1;
+        } else {
+            order = compareNames(l.name_, r.name_);
+        }
+        if (order == 0) {
+            return lhs < rhs;
+        }
+        return descending_ ? order > 0 : order < 0;
+    }
+
+    void FileBrowser::restartView() noexcept
+    {
+        view_.clear();
+        pending_.resize(entries_.size());
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            pending_[i] = static_cast<uint32_t>(i);
+        }
+        std::fill(place_.begin(), place_.end(), Pending);
+    }
+
+    void FileBrowser::SetFilter(const char* filter) noexcept
+    {
+        if (filter != filterBuffer_) {
+            (void) snprintf(filterBuffer_, sizeof(filterBuffer_), "%s", filter);
+        }
+        std::string lowered(filterBuffer_);
+        std::transform(lowered.begin(), lowered.end(), lowered.begin(), lower);
+
+        // A filter containing the old one only matches a subset of its entries, which are
+        // already in order. Pending entries are filtered as they are merged.
+        const bool narrowing = lowered.find(filter_) != std::string::npos;
+        filter_              = std::move(lowered);
+        if (!narrowing) {
+            restartView();
+            return;
+        }
+        view_.erase(std::remove_if(view_.begin(), view_.end(),
+                                   [this](uint32_t index) {
+                                       if (matches(entries_[index])) {
+                                           return false;
+                                       }
+                                       place_[index] = Filtered;
+                                       return true;
+                                   }),
+                    view_.end());
+    }
+
+    void FileBrowser::Update() noexcept
+    {
+        if (listing_ != nullptr && !listed_) {
+            std::vector<FileEntry> listed;
+            std::vector<FileStat>  statted;
+            {
+                const std::lock_guard<std::mutex> lock(listing_->mutex_);
+                listed.swap(listing_->listed_);
+                statted.swap(listing_->statted_);
+                listed_ = listing_->enumerated_ && listing_->unstatted_ == 0;
+                error_  = listing_->error_;
+            }
+
+            for (FileEntry& entry : listed) {
+                pending_.push_back(static_cast<uint32_t>(entries_.size()));
+                place_.push_back(Pending);
+                entries_.push_back(std::move(entry));
+            }
+
+            // Entries already in the view move if their sort key changed.
+            bool relocate = false;
+            for (const FileStat& stat : statted) {
+                FileEntry& entry = entries_[stat.index_];
+                entry.statted_   = true;
+                if (!stat.valid_) {
+                    continue;
+                }
+                const bool moves = sortBy_ != SortBy::Name || entry.directory_ != stat.directory_;
+                entry.size_      = stat.size_;
+                entry.modified_  = stat.modified_;
+                entry.directory_ = stat.directory_;
+                if (moves && place_[stat.index_] == InView) {
+                    place_[stat.index_] = Pending;
+                    pending_.push_back(stat.index_);
+                    relocate = true;
+                }
+            }
+            if (relocate) {
+                view_.erase(std::remove_if(view_.begin(), view_.end(),
+                                           [this](uint32_t index) {
+                                               return place_[index] == Pending;
+                                           }),
+                            view_.end());
+            }
+        }
+
+        // Filter, sort and merge pending entries a chunk at a time, so that the view is
+        // always in order and a big rebuild is spread over frames.
+        const auto deadline = Clock::now() + budget_;
+        const auto order    = [this](uint32_t lhs, uint32_t rhs) { return before(lhs, rhs); };
+        while (!pending_.empty()) {
+            const auto   chunkStart = Clock::now();
+            const size_t count      = std::min(pending_.size(), chunkSize_);
+            chunk_.clear();
+            for (auto it = pending_.end() - static_cast<ptrdiff_t>(count); it != pending_.end();
+                 ++it) {
+                const bool match = matches(entries_[*it]);
+                place_[*it]      = match ? InView : Filtered;
+                if (match) {
+                    chunk_.push_back(*it);
+                }
+            }
+            pending_.resize(pending_.size() - count);
+            std::sort(chunk_.begin(), chunk_.end(), order);
+
+            // Merge by searching the view for where each entry goes, rather than comparing
+            // every entry in the view: the view is much bigger than a chunk, and comparing
+            // names costs far more than copying the indices in between. Each search gallops
+            // forward from where the last entry went.
+            merged_.clear();
+            merged_.reserve(view_.size() + chunk_.size());
+            auto from = view_.begin();
+            for (const uint32_t index : chunk_) {
+                ptrdiff_t step = 1;
+                auto      last = from;
+                while (step < view_.end() - last && !order(index, last[step])) {
+                    last += step;
+                    step *= 2;
+                }
+                const auto to = std::upper_bound(last, last + std::min(step, view_.end() - last),
+                                                 index, order);
+                merged_.insert(merged_.end(), from, to);
+                merged_.push_back(index);
+                from = to;
+            }
+            merged_.insert(merged_.end(), from, view_.end());
+            view_.swap(merged_);
+
+            // Size the next chunk to take about a ChunksPerFrame'th of the budget.
+            const auto now    = Clock::now();
+            const auto took   = now - chunkStart;
+            const auto target = budget_ / ChunksPerFrame;
+            if (took > target) {
+                chunkSize_ /= 2;
+            } else if (took * 2 < target) {
+                chunkSize_ *= 2;
+            }
+            chunkSize_ = std::min(std::max({chunkSize_, MinChunk, view_.size() / ViewShare}),
+                                  MaxChunk);
+            if (now >= deadline) {
+                break;
+            }
+        }
+    }
+
+    void FileBrowser::drawTable(const ImVec2& size, bool& chosen) noexcept
+    {
+        constexpr ImGuiTableFlags flags =
+            ImGuiTableFlags_Sortable | ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg |
+            ImGuiTableFlags_Resizable | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_BordersV;
+
+        int64_t open = -1;
+        dear::Table("##entries", 3, flags, size) && [&] {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_DefaultSort |
+                                                ImGuiTableColumnFlags_WidthStretch);
+            ImGui::TableSetupColumn("Size", ImGuiTableColumnFlags_WidthFixed);
+            ImGui::TableSetupColumn("Modified", ImGuiTableColumnFlags_WidthFixed);
+            ImGui::TableHeadersRow();
+
+            ImGuiTableSortSpecs* specs = ImGui::TableGetSortSpecs();
+            if (specs != nullptr && specs->SpecsDirty) {
+                const SortBy sortBy =
+                    specs->SpecsCount > 0 ? static_cast<SortBy>(specs->Specs[0].ColumnIndex)
+                                          : SortBy::Name;
+                const bool descending = specs->SpecsCount > 0 &&
+                                        specs->Specs[0].SortDirection ==
+                                            ImGuiSortDirection_Descending;
+                specs->SpecsDirty = false;
+                if (sortBy != sortBy_ || descending != descending_) {
+                    sortBy_     = sortBy;
+                    descending_ = descending;
+                    restartView();
+                    Update();
+                }
+            }
+
+            // Names can be up to 255 bytes (more in UTF-8 on Windows).
+            char             text[1024];
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(view_.size()));
+            while (clipper.Step()) {
+                for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                    const uint32_t   index = view_[static_cast<size_t>(row)];
+                    const FileEntry& entry = entries_[index];
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::PushID(static_cast<int>(index));
+                    (void) snprintf(text, sizeof(text), "%s%s", entry.directory_ ? "[+] " : "",
+                                    entry.name_.c_str());
+                    if (dear::Selectable(text, selected_ == index,
+                                         ImGuiSelectableFlags_SpanAllColumns |
+                                             ImGuiSelectableFlags_AllowDoubleClick)) {
+                        selected_ = index;
+                        if (ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left)) {
+                            if (entry.directory_) {
+                                open = index;
+                            } else {
+                                chosen = true;
+                            }
+                        }
+                    }
+                    ImGui::PopID();
+
+                    ImGui::TableNextColumn();
+                    if (!entry.statted_) {
+                        ImGui::TextDisabled("...");
+                    } else if (!entry.directory_) {
+                        formatSize(text, sizeof(text), entry.size_);
+                        ImGui::TextUnformatted(text);
+                    }
+                    ImGui::TableNextColumn();
+                    if (entry.statted_) {
+                        formatTime(text, sizeof(text), entry.modified_);
+                        ImGui::TextUnformatted(text);
+                    }
+                }
+            }
+        };
+
+        if (open >= 0) {
+            Open(childPath(path_, entries_[static_cast<size_t>(open)].name_).c_str());
+        }
+    }
+
+    bool FileBrowser::Draw(const char* str_id, const ImVec2& size) noexcept
+    {
+        Update();
+
+        bool chosen = false;
+        ImGui::PushID(str_id);
+
+        if (ImGui::Button("Up")) {
+            Open(parentPath(path_).c_str());
+        }
+        ImGui::SameLine();
+        ImGui::TextUnformatted(path_.c_str());
+
+        ImGui::SetNextItemWidth(-FLT_MIN);
+        if (ImGui::InputTextWithHint("##filter", "filter", filterBuffer_, sizeof(filterBuffer_))) {
+            SetFilter(filterBuffer_);
+        }
+
+        if (!error_.empty()) {
+            ImGui::TextDisabled("%s", error_.c_str());
+        } else {
+            ImGui::TextDisabled("%zu of %zu entries%s%s", view_.size(), entries_.size(),
+                                Listing() ? " (listing)" : "", Sorting() ? " (sorting)" : "");
+        }
+
+        drawTable(size, chosen);
+
+        ImGui::PopID();
+        return chosen;
+    }
+}  // namespace dear
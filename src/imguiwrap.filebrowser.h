@@ -0,0 +1,137 @@
+#pragma once
+
+#include "imguiwrap.dear.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dear
+{
+    namespace detail
+    {
+        struct FileListing;
+    }  // namespace detail
+
+    // FileEntry is one entry of the directory a FileBrowser is showing.
+    struct FileEntry
+    {
+        std::string name_;
+        uint64_t    size_{0};
+        int64_t     modified_{0};  // seconds since the Unix epoch
+        bool        directory_{false};
+
+        // statted_ is false until size_ and modified_ have been read (and, on file systems
+        // that don't report the type while listing, directory_).
+        bool statted_{false};
+    };
+
+    // FileBrowser lists a directory for a file-open dialog, for directories with hundreds
+    // of thousands of entries, where listing them with dear::ListBox and dear::Selectable
+    // would stall the UI thread on readdir and stat.
+    //
+    // - A background thread lists the directory, handing entries to the UI in batches (the
+    //   first ones straight away), while worker threads stat them,
+    // - Entries are shown as they arrive: each frame, new entries that match the filter are
+    //   sorted among themselves and merged into the sorted view, and entries whose size or
+    //   date arrive are moved if the view is sorted by them,
+    // - Changing the sort order or widening the filter rebuilds the view the same way, a
+    //   chunk at a time within a per-frame budget; narrowing the filter just drops the
+    //   entries that no longer match,
+    // - Only the visible rows are submitted, via ImGuiListClipper.
+    //
+    //   static dear::FileBrowser browser(".");
+    //   dear::Begin("Open") && [] {
+    //       if (browser.Draw("##files", ImVec2(0, 400)))
+    //           open(browser.SelectedPath());
+    //   };
+    //
+    // Directories are listed first; the filter is a case-insensitive (ASCII) substring
+    // match on the name. Open and the destructor don't wait for the threads listing the
+    // previous directory: they are told to stop, and finish in the background.
+    class FileBrowser
+    {
+    public:
+        explicit FileBrowser(const char* path = ".") noexcept;
+        ~FileBrowser();
+
+        FileBrowser(const FileBrowser&) = delete;
+        FileBrowser& operator=(const FileBrowser&) = delete;
+
+        // Open starts listing another directory, abandoning the current listing.
+        void Open(const char* path) noexcept;
+
+        const std::string& Path() const noexcept { return path_; }
+
+        // Draw presents the path, the filter input and the entries in a table of the given
+        // size. Double-clicking a directory opens it; Draw returns true when a file is
+        // double-clicked.
+        bool Draw(const char* str_id, const ImVec2& size = Zero) noexcept;
+
+        // SetFilter replaces the filter text, as if the user had typed it.
+        void SetFilter(const char* filter) noexcept;
+
+        // Selected returns the selected entry, or nullptr; SelectedPath its full path, or
+        // an empty string.
+        const FileEntry* Selected() const noexcept;
+        std::string      SelectedPath() const noexcept;
+
+        // Entries are all the entries received so far, in the order they were listed, and
+        // View the indices of those shown, in display order.
+        const std::vector<FileEntry>& Entries() const noexcept { return entries_; }
+        const std::vector<uint32_t>&  View() const noexcept { return view_; }
+
+        // Listing is true until the directory has been listed and every entry statted,
+        // and Sorting while entries are waiting to be merged into the view.
+        bool Listing() const noexcept;
+        bool Sorting() const noexcept { return !pending_.empty(); }
+
+        // Error describes why the directory couldn't be listed, or is empty.
+        const std::string& Error() const noexcept { return error_; }
+
+        // Update takes the entries and stats that have arrived and merges them into the
+        // view, within the frame budget. Draw calls it; call it yourself to drive a
+        // FileBrowser that isn't drawn.
+        void Update() noexcept;
+
+        // SetFrameBudget limits how long Update spends sorting per frame.
+        void SetFrameBudget(std::chrono::microseconds budget) noexcept { budget_ = budget; }
+
+    private:
+        enum class SortBy
+        {
+            Name,
+            Size,
+            Modified
+        };
+
+        void stop() noexcept;
+        void restartView() noexcept;
+        bool matches(const FileEntry& entry) const noexcept;
+        bool before(uint32_t lhs, uint32_t rhs) const noexcept;
+        void drawTable(const ImVec2& size, bool& chosen) noexcept;
+
+        std::string                          path_;
+        std::shared_ptr<detail::FileListing> listing_;  // shared with its threads
+        bool                                 listed_{false};
+        std::string                          error_;
+
+        // entries_ is in listing order; place_ says where each entry is (see Place).
+        std::vector<FileEntry> entries_;
+        std::vector<uint8_t>   place_;
+        std::vector<uint32_t>  view_;     // sorted, matching the filter
+        std::vector<uint32_t>  pending_;  // to be filtered and merged into view_
+        std::vector<uint32_t>  chunk_;
+        std::vector<uint32_t>  merged_;
+        size_t                 chunkSize_{1024};
+
+        SortBy                    sortBy_{SortBy::Name};
+        bool                      descending_{false};
+        std::string               filter_;  // lower-cased
+        char                      filterBuffer_[256]{};
+        int64_t                   selected_{-1};
+        std::chrono::microseconds budget_{4000};
+    };
+}  // namespace dear
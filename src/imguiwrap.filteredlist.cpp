@@ -0,0 +1,253 @@
+#include "imguiwrap.filteredlist.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <utility>
+
+namespace
+{
+    // Trigrams are hashed into this many buckets; collisions only cost extra candidates,
+    // since every candidate is verified.
+    constexpr uint32_t BucketBits  = 18;
+    constexpr uint32_t BucketCount = 1U << BucketBits;
+
+    constexpr char
+    lower(char c) noexcept
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    constexpr uint32_t
+    trigramBucket(char a, char b, char c) noexcept
+    {
+        const uint32_t key = (static_cast<uint32_t>(static_cast<unsigned char>(a)) << 16U) |
+                             (static_cast<uint32_t>(static_cast<unsigned char>(b)) << 8U) |
+                             static_cast<uint32_t>(static_cast<unsigned char>(c));
+        // Fibonacci hashing.
+        return (key * 2654435761U) >> (32U - BucketBits);
+    }
+
+    // forEachBucket calls fn with each distinct trigram bucket of a lower-cased string.
+    template<typename Fn>
+    void
+    forEachBucket(const char* text, size_t length, std::vector<uint32_t>& scratch, Fn&& fn)
+    {
+        scratch.clear();
+        for (size_t i = 0; i + 2 < length; ++i) {
+            scratch.push_back(trigramBucket(text[i], text[i + 1], text[i + 2]));
+        }
+        std::sort(scratch.begin(), scratch.end());
+        scratch.erase(std::unique(scratch.begin(), scratch.end()), scratch.end());
+        for (const uint32_t bucket : scratch) {
+            fn(bucket);
+        }
+    }
+
+    bool
+    containsNoCase(std::string_view haystack, std::string_view needle) noexcept
+    {
+        if (needle.size() > haystack.size()) {
+            return false;
+        }
+        const auto it = std::search(haystack.begin(), haystack.end(), needle.begin(), needle.end(),
+                                    [](char h, char n) { return lower(h) == n; });
+        return it != haystack.end();
+    }
+
+}  // namespace
+
+namespace dear
+{
+    FilteredList::FilteredList(std::vector<std::string> items) noexcept : items_(std::move(items))
+    {
+        restartQuery();
+        builder_ = std::thread([this] { buildIndex(); });
+    }
+
+    FilteredList::~FilteredList()
+    {
+        cancel_.store(true, std::memory_order_relaxed);
+        if (builder_.joinable()) {
+            builder_.join();
+        }
+    }
+
+    void FilteredList::buildIndex() noexcept
+    {
+        // Lower-cased copy of all the labels, back to back, for fast verification.
+        size_t total = 0;
+        for (const auto& item : items_) {
+            total += item.size();
+        }
+        lowered_.resize(total);
+        loweredOffset_.resize(items_.size() + 1);
+        size_t offset = 0;
+        for (size_t i = 0; i < items_.size(); ++i) {
+            loweredOffset_[i] = static_cast<uint32_t>(offset);
+            std::transform(items_[i].begin(), items_[i].end(), lowered_.begin() + offset, lower);
+            offset += items_[i].size();
+        }
+        loweredOffset_[items_.size()] = static_cast<uint32_t>(offset);
+        if (cancel_.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        // Two passes over the trigrams: count postings per bucket, then fill them.
+        std::vector<uint32_t> scratch;
+        bucketStart_.assign(BucketCount + 1, 0);
+        for (size_t i = 0; i < items_.size(); ++i) {
+            forEachBucket(&lowered_[loweredOffset_[i]], loweredOffset_[i + 1] - loweredOffset_[i],
+                          scratch, [this](uint32_t bucket) { ++bucketStart_[bucket + 1]; });
+        }
+        for (uint32_t b = 0; b < BucketCount; ++b) {
+            bucketStart_[b + 1] += bucketStart_[b];
+        }
+        if (cancel_.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        postings_.resize(bucketStart_[BucketCount]);
+        std::vector<uint32_t> fill(bucketStart_.begin(), bucketStart_.end() - 1);
+        for (size_t i = 0; i < items_.size(); ++i) {
+            forEachBucket(&lowered_[loweredOffset_[i]], loweredOffset_[i + 1] - loweredOffset_[i],
+                          scratch, [&](uint32_t bucket) {
+                              postings_[fill[bucket]++] = static_cast<uint32_t>(i);
+                          });
+        }
+
+        ready_.store(true, std::memory_order_release);
+    }
+
+    bool FilteredList::itemMatches(uint32_t item) const noexcept
+    {
+        if (IndexReady()) {
+            const std::string_view label(&lowered_[loweredOffset_[item]],
+                                         loweredOffset_[item + 1] - loweredOffset_[item]);
+            return label.find(filter_) != std::string_view::npos;
+        }
+        return containsNoCase(items_[item], filter_);
+    }
+
+    void FilteredList::SetFilter(const char* filter) noexcept
+    {
+        (void) snprintf(filterBuffer_, sizeof(filterBuffer_), "%s", filter);
+        restartQuery();
+    }
+
+    void FilteredList::restartQuery() noexcept
+    {
+        std::string filter(filterBuffer_);
+        std::transform(filter.begin(), filter.end(), filter.begin(), lower);
+
+        // If the last query completed and the new filter contains its text, the new
+        // matches are a subset of the old ones, so only those need checking.
+        const bool narrowing = complete_ && !lastFilter_.empty() &&
+                               filter.find(lastFilter_) != std::string::npos;
+
+        filter_   = std::move(filter);
+        cursor_   = 0;
+        complete_ = false;
+        scanAll_  = false;
+        candidates_.clear();
+
+        if (filter_.empty()) {
+            matches_.resize(items_.size());
+            for (size_t i = 0; i < items_.size(); ++i) {
+                matches_[i] = static_cast<uint32_t>(i);
+            }
+            complete_   = true;
+            lastFilter_.clear();
+            return;
+        }
+
+        // The rarest trigram's posting list is a superset of the matches.
+        const bool indexed = filter_.size() >= 3 && IndexReady();
+        size_t     first = 0, last = 0;
+        if (indexed) {
+            size_t best = SIZE_MAX;
+            for (size_t i = 0; i + 2 < filter_.size(); ++i) {
+                const uint32_t bucket = trigramBucket(filter_[i], filter_[i + 1], filter_[i + 2]);
+                const size_t   count  = bucketStart_[bucket + 1] - bucketStart_[bucket];
+                if (count < best) {
+                    best  = count;
+                    first = bucketStart_[bucket];
+                    last  = bucketStart_[bucket + 1];
+                }
+            }
+        }
+
+        if (narrowing && (!indexed || matches_.size() <= last - first)) {
+            candidates_.swap(matches_);
+        } else if (indexed) {
+            candidates_.assign(postings_.begin() + static_cast<ptrdiff_t>(first),
+                               postings_.begin() + static_cast<ptrdiff_t>(last));
+        } else {
+            scanAll_ = true;
+        }
+        matches_.clear();
+    }
+
+    void FilteredList::advanceQuery() noexcept
+    {
+        if (complete_) {
+            return;
+        }
+        const auto   deadline = std::chrono::steady_clock::now() + budget_;
+        const size_t count    = scanAll_ ? items_.size() : candidates_.size();
+        // Check the clock every so often rather than for every item.
+        constexpr size_t Stride = 1024;
+        while (cursor_ < count) {
+            const size_t end = std::min(count, cursor_ + Stride);
+            for (; cursor_ < end; ++cursor_) {
+                const auto item = scanAll_ ? static_cast<uint32_t>(cursor_) : candidates_[cursor_];
+                if (itemMatches(item)) {
+                    matches_.push_back(item);
+                }
+            }
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return;
+            }
+        }
+        complete_   = true;
+        lastFilter_ = filter_;
+        candidates_.clear();
+        candidates_.shrink_to_fit();
+    }
+
+    bool FilteredList::Draw(const char* label, const ImVec2& size) noexcept
+    {
+        bool changed = false;
+        ImGui::PushID(label);
+
+        ImGui::SetNextItemWidth(-FLT_MIN);
+        if (ImGui::InputTextWithHint("##filter", label, filterBuffer_, sizeof(filterBuffer_))) {
+            restartQuery();
+        }
+        advanceQuery();
+
+        ImGui::TextDisabled("%zu of %zu%s%s", matches_.size(), items_.size(),
+                            complete_ ? "" : " (searching)", IndexReady() ? "" : " (indexing)");
+
+        dear::ListBox("##items", size) && [&] {
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(matches_.size()));
+            while (clipper.Step()) {
+                for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                    const auto item = static_cast<int>(matches_[static_cast<size_t>(row)]);
+                    ImGui::PushID(item);
+                    if (dear::Selectable(items_[static_cast<size_t>(item)], item == selected_)) {
+                        changed   = item != selected_;
+                        selected_ = item;
+                    }
+                    ImGui::PopID();
+                }
+            }
+        };
+
+        ImGui::PopID();
+        return changed;
+    }
+}  // namespace dear
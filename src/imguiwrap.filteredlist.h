@@ -0,0 +1,93 @@
+#pragma once
+
+#include "imguiwrap.dear.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dear
+{
+    // FilteredList is a filter box over a selectable list, for lists with hundreds of
+    // thousands or millions of items where ImGuiTextFilter + dear::Selectable would rescan
+    // every label on every frame.
+    //
+    // - A background thread builds a trigram index over the (lower-cased) labels when the
+    //   list is constructed,
+    // - The matching item indices are cached between frames and only recomputed when the
+    //   filter text changes,
+    // - When the filter grows (e.g. "foo" -> "foob"), only the previous matches are
+    //   re-checked; otherwise candidates come from the rarest trigram in the filter,
+    // - Candidates are verified within a per-frame time budget, so a large scan is spread
+    //   over several frames instead of stalling one,
+    // - Only the visible rows are submitted, via ImGuiListClipper.
+    //
+    // Matching is a case-insensitive (ASCII) substring match.
+    class FilteredList
+    {
+    public:
+        // Takes ownership of the labels and starts indexing them in the background.
+        explicit FilteredList(std::vector<std::string> items) noexcept;
+        ~FilteredList();
+
+        FilteredList(const FilteredList&) = delete;
+        FilteredList& operator=(const FilteredList&) = delete;
+
+        // Draw presents the filter input and the list box (of the given size), returning
+        // true if the selection changed.
+        bool Draw(const char* label, const ImVec2& size = Zero) noexcept;
+
+        // SetFilter replaces the filter text, as if the user had typed it.
+        void SetFilter(const char* filter) noexcept;
+
+        // Selected returns the index (into the original items) of the selected item, or -1.
+        int  Selected() const noexcept { return selected_; }
+        void Select(int index) noexcept { selected_ = index; }
+
+        // Matches returns the indices of the items matching the filter so far; Searching
+        // is true while candidates are still being verified.
+        const std::vector<uint32_t>& Matches() const noexcept { return matches_; }
+        bool                         Searching() const noexcept { return !complete_; }
+
+        // IndexReady is true once the background indexing has finished.
+        bool IndexReady() const noexcept { return ready_.load(std::memory_order_acquire); }
+
+        const std::vector<std::string>& Items() const noexcept { return items_; }
+
+        // SetFrameBudget limits how long Draw spends verifying candidates per frame.
+        void SetFrameBudget(std::chrono::microseconds budget) noexcept { budget_ = budget; }
+
+    private:
+        void buildIndex() noexcept;
+        void restartQuery() noexcept;
+        void advanceQuery() noexcept;
+        bool itemMatches(uint32_t item) const noexcept;
+
+        std::vector<std::string> items_;
+
+        // Built by the background thread, read-only once ready_ is set.
+        std::vector<char>     lowered_;        // all labels, lower-cased, back to back
+        std::vector<uint32_t> loweredOffset_;  // start of each label in lowered_, plus end
+        std::vector<uint32_t> bucketStart_;    // postings_ offsets per trigram bucket
+        std::vector<uint32_t> postings_;       // item indices, ascending within each bucket
+        std::atomic<bool>     ready_{false};
+        std::atomic<bool>     cancel_{false};
+        std::thread           builder_;
+
+        // Query state.
+        std::string               filter_;       // lower-cased filter text
+        std::string               lastFilter_;   // filter of the last completed query
+        std::vector<uint32_t>     candidates_;   // items still to verify, unless scanAll_
+        bool                      scanAll_{false};
+        size_t                    cursor_{0};    // next candidate to verify
+        bool                      complete_{true};
+        std::vector<uint32_t>     matches_;
+        std::chrono::microseconds budget_{4000};
+
+        char filterBuffer_[256]{};
+        int  selected_{-1};
+    };
+}  // namespace dear
@@ -0,0 +1,335 @@
+#include "imguiwrap.fonts.h"
+#include "imguiwrap.h"
+#include "imguiwrap.mappedfile.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    // Placeholders encode their codepoint as the U coordinate (c + 0.5) / CodepointScale
+    // within a row of the atlas that is left transparent.
+    constexpr float CodepointScale = static_cast<float>(IM_UNICODE_CODEPOINT_MAX) + 1.0F;
+
+    // Atlas width to use when the application hasn't chosen one; the transparent row has
+    // to span it, so it has to be known before the atlas is built.
+    constexpr int DefaultAtlasWidth = 1024;
+
+    // CodepointSet is empty until the first Clear(), so it costs nothing unless used.
+    class CodepointSet
+    {
+    public:
+        bool Test(unsigned int c) const noexcept
+        {
+            return (bits_[c >> 5U] >> (c & 31U) & 1U) != 0;
+        }
+        void Set(unsigned int c) noexcept { bits_[c >> 5U] |= 1U << (c & 31U); }
+        void Clear() noexcept { bits_.assign((IM_UNICODE_CODEPOINT_MAX + 32) / 32, 0); }
+
+    private:
+        std::vector<uint32_t> bits_;
+    };
+
+    // Source is one font file added to the atlas, in the same order as atlas->ConfigData.
+    struct Source
+    {
+        dear::MappedFile     file_;
+        const ImWchar*       requested_{nullptr};
+        std::vector<ImWchar> rasterized_;
+    };
+
+    struct FontsState
+    {
+        ImFontAtlas*        atlas_{nullptr};
+        bool                dynamic_{false};
+        bool                dirty_{false};
+        std::vector<Source> sources_;
+        CodepointSet        used_;     // placeholders that have been drawn
+        CodepointSet        scratch_;  // codepoints a font has, while adding placeholders
+        int                 blankRect_{-1};
+        float               blankV_{-1.0F};
+        dear::GlyphStats    stats_{};
+    };
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    FontsState fonts;
+
+    // Codepoints rasterized from the start: ASCII, and ImGui's fallback and ellipsis
+    // characters, which it looks up without falling back.
+    bool
+    alwaysRasterized(unsigned int c) noexcept
+    {
+        return (c >= 0x20 && c < 0x7F) || c == 0xFFFD || c == 0x2026 || c == 0x0085;
+    }
+
+    // East Asian wide characters are usually an em across.
+    bool
+    wide(unsigned int c) noexcept
+    {
+        return (c >= 0x1100 && c <= 0x115F) || (c >= 0x2E80 && c <= 0xA4CF) ||
+               (c >= 0xAC00 && c <= 0xD7A3) || (c >= 0xF900 && c <= 0xFAFF) ||
+               (c >= 0xFE30 && c <= 0xFE4F) || (c >= 0xFF00 && c <= 0xFF60) ||
+               (c >= 0xFFE0 && c <= 0xFFE6);
+    }
+
+    bool
+    isSeparator(char c) noexcept
+    {
+#if defined(_WIN32)
+        return c == '/' || c == '\\';
+#else
+        return c == '/';
+#endif
+    }
+
+    // baseName returns the file name part of path, for the font's name.
+    const char*
+    baseName(const char* path) noexcept
+    {
+        const char* name = path;
+        for (const char* c = path; *c != '\0'; ++c) {
+            if (isSeparator(*c)) {
+                name = c + 1;
+            }
+        }
+        return name;
+    }
+
+    // updateRanges points each font configuration at the ranges of its requested
+    // codepoints that are to be rasterized.
+    void
+    updateRanges() noexcept
+    {
+        ImFontAtlas* atlas = fonts.atlas_;
+        for (size_t i = 0; i < fonts.sources_.size(); ++i) {
+            Source& source = fonts.sources_[i];
+            source.rasterized_.clear();
+            for (const ImWchar* range = source.requested_; range[0] != 0; range += 2) {
+                for (unsigned int c = range[0]; c <= range[1]; ++c) {
+                    if (!alwaysRasterized(c) && !fonts.used_.Test(c)) {
+                        continue;
+                    }
+                    if (!source.rasterized_.empty() && source.rasterized_.back() + 1U == c) {
+                        source.rasterized_.back() = static_cast<ImWchar>(c);
+                    } else {
+                        source.rasterized_.push_back(static_cast<ImWchar>(c));
+                        source.rasterized_.push_back(static_cast<ImWchar>(c));
+                    }
+                }
+            }
+            source.rasterized_.push_back(0);
+            atlas->ConfigData[static_cast<int>(i)].GlyphRanges = source.rasterized_.data();
+        }
+    }
+
+    // addPlaceholders gives each font a placeholder for every requested codepoint it
+    // doesn't have a glyph for. Codepoints that have been drawn but still have no glyph
+    // aren't in the font file, and are left to ImGui's fallback.
+    void
+    addPlaceholders() noexcept
+    {
+        ImFontAtlas* atlas = fonts.atlas_;
+        const float  v     = fonts.blankV_;
+        size_t       added = 0;
+        for (ImFont* font : atlas->Fonts) {
+            fonts.scratch_.Clear();
+            for (const ImFontGlyph& glyph : font->Glyphs) {
+                fonts.scratch_.Set(glyph.Codepoint);
+            }
+            for (size_t i = 0; i < fonts.sources_.size(); ++i) {
+                if (atlas->ConfigData[static_cast<int>(i)].DstFont != font) {
+                    continue;
+                }
+                for (const ImWchar* range = fonts.sources_[i].requested_; range[0] != 0;
+                     range += 2) {
+                    for (unsigned int c = range[0]; c <= range[1]; ++c) {
+                        if (fonts.scratch_.Test(c) || fonts.used_.Test(c) || alwaysRasterized(c)) {
+                            continue;
+                        }
+                        fonts.scratch_.Set(c);
+                        const float u       = (static_cast<float>(c) + 0.5F) / CodepointScale;
+                        const float advance = wide(c) ? font->FontSize : font->FallbackAdvanceX;
+                        font->AddGlyph(nullptr, static_cast<ImWchar>(c), 0.0F, 0.0F, 1.0F, 1.0F,
+                                       u, v, u, v, advance);
+                        ++added;
+                    }
+                }
+            }
+            font->BuildLookupTable();
+        }
+        fonts.stats_.placeholders_ = added;
+    }
+
+    void
+    build() noexcept
+    {
+        const auto   start = std::chrono::steady_clock::now();
+        ImFontAtlas* atlas = fonts.atlas_;
+        updateRanges();
+        atlas->ClearTexData();
+        if (!atlas->Build()) {
+            (void) fprintf(stderr, "imguiwrap: font atlas build failed\n");
+            return;
+        }
+
+        const ImFontAtlasCustomRect* blank = atlas->GetCustomRectByIndex(fonts.blankRect_);
+        fonts.blankV_ =
+            (static_cast<float>(blank->Y) + 0.5F) / static_cast<float>(atlas->TexHeight);
+
+        size_t glyphs = 0;
+        for (const ImFont* font : atlas->Fonts) {
+            glyphs += static_cast<size_t>(font->Glyphs.Size);
+        }
+        addPlaceholders();
+
+        fonts.stats_.rasterized_  = glyphs;
+        fonts.stats_.atlasWidth_  = atlas->TexWidth;
+        fonts.stats_.atlasHeight_ = atlas->TexHeight;
+        fonts.stats_.lastBuildMs_ = std::chrono::duration<float, std::milli>(
+                                        std::chrono::steady_clock::now() - start)
+                                        .count();
+        ++fonts.stats_.rebuilds_;
+    }
+
+    // scanCommand marks the placeholders drawn by one command. Placeholders only come in
+    // whole quads with identical texture coordinates, so the first corner of each triangle
+    // is enough to find them.
+    bool
+    scanCommand(const ImDrawList* list, const ImDrawCmd& cmd) noexcept
+    {
+        bool              found = false;
+        const ImDrawIdx*  idx   = list->IdxBuffer.Data + cmd.IdxOffset;
+        const ImDrawVert* vtx   = list->VtxBuffer.Data + cmd.VtxOffset;
+        for (unsigned int i = 0; i + 2 < cmd.ElemCount; i += 3) {
+            const ImVec2& uv = vtx[idx[i]].uv;
+            if (uv.y != fonts.blankV_) {
+                continue;
+            }
+            const auto c = static_cast<unsigned int>(uv.x * CodepointScale);
+            if (c <= IM_UNICODE_CODEPOINT_MAX && !fonts.used_.Test(c)) {
+                fonts.used_.Set(c);
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    // scan only looks at commands drawing with the font atlas, so frames full of images or
+    // other textures cost next to nothing.
+    bool
+    scan(const ImDrawData* drawData) noexcept
+    {
+        bool              found = false;
+        const ImTextureID atlas = fonts.atlas_->TexID;
+        for (int n = 0; drawData != nullptr && n < drawData->CmdListsCount; ++n) {
+            const ImDrawList* list = drawData->CmdLists[n];
+            for (const ImDrawCmd& cmd : list->CmdBuffer) {
+                if (cmd.UserCallback == nullptr && cmd.TextureId == atlas) {
+                    found |= scanCommand(list, cmd);
+                }
+            }
+        }
+        return found;
+    }
+
+}  // namespace
+
+namespace dear
+{
+    GlyphStats GetGlyphStats() noexcept
+    {
+        GlyphStats stats = fonts.stats_;
+        stats.dynamic_   = fonts.dynamic_;
+        if (!fonts.dynamic_ && ImGui::GetCurrentContext() != nullptr) {
+            const ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+            stats.rasterized_        = 0;
+            for (const ImFont* font : atlas->Fonts) {
+                stats.rasterized_ += static_cast<size_t>(font->Glyphs.Size);
+            }
+            stats.atlasWidth_  = atlas->TexWidth;
+            stats.atlasHeight_ = atlas->TexHeight;
+        }
+        return stats;
+    }
+
+    namespace detail
+    {
+        void FontsLoad(ImFontAtlas* atlas, const ImGuiWrapFont* specs, int count,
+                       bool dynamic) noexcept
+        {
+            fonts.atlas_ = atlas;
+            for (int i = 0; i < count; ++i) {
+                const ImGuiWrapFont& spec = specs[i];
+                if (spec.mergeMode_ && atlas->Fonts.empty()) {
+                    continue;
+                }
+                Source source{};
+                if (spec.path_ == nullptr || !source.file_.Open(spec.path_) ||
+                    source.file_.Size() == 0) {
+                    (void) fprintf(stderr, "imguiwrap: couldn't load font %s\n",
+                                   spec.path_ != nullptr ? spec.path_ : "(null)");
+                    continue;
+                }
+                source.requested_ = spec.glyphRanges_ != nullptr ? spec.glyphRanges_
+                                                                 : atlas->GetGlyphRangesDefault();
+
+                ImFontConfig config{};
+                // stb_truetype only reads the font data, so the read-only mapping will do.
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+                config.FontData             = const_cast<uint8_t*>(source.file_.Data());
+                config.FontDataSize         = static_cast<int>(source.file_.Size());
+                config.FontDataOwnedByAtlas = false;
+                config.SizePixels           = spec.sizePixels_;
+                config.MergeMode            = spec.mergeMode_;
+                config.GlyphRanges          = source.requested_;
+                (void) snprintf(config.Name, sizeof(config.Name), "%s, %.0fpx",
+                                baseName(spec.path_), spec.sizePixels_);
+                (void) atlas->AddFont(&config);
+                fonts.sources_.push_back(std::move(source));
+            }
+
+            if (!dynamic || fonts.sources_.empty()) {
+                return;
+            }
+            fonts.dynamic_ = true;
+            fonts.used_.Clear();
+            if (atlas->TexDesiredWidth <= 0) {
+                atlas->TexDesiredWidth = DefaultAtlasWidth;
+            }
+            fonts.blankRect_ =
+                atlas->AddCustomRectRegular(atlas->TexDesiredWidth - atlas->TexGlyphPadding, 1);
+            build();
+        }
+
+        bool FontsScan() noexcept
+        {
+            // Once every requested codepoint has been rasterized there is nothing to find.
+            if (!fonts.dynamic_ || fonts.stats_.placeholders_ == 0) {
+                return false;
+            }
+#ifdef IMGUI_HAS_VIEWPORT
+            for (const ImGuiViewport* viewport : ImGui::GetPlatformIO().Viewports) {
+                fonts.dirty_ |= scan(viewport->DrawData);
+            }
+#else
+            fonts.dirty_ |= scan(ImGui::GetDrawData());
+#endif
+            return fonts.dirty_;
+        }
+
+        void FontsRebuild() noexcept
+        {
+            if (fonts.dirty_) {
+                fonts.dirty_ = false;
+                build();
+            }
+        }
+
+        int FontsGeneration() noexcept { return fonts.stats_.rebuilds_; }
+
+        void FontsStop() noexcept { fonts = FontsState{}; }
+    }  // namespace detail
+}  // namespace dear
@@ -0,0 +1,77 @@
+#pragma once
+
+// Font loading for imgui_main (ImGuiWrapConfig::fonts_), and the dynamic glyph atlas
+// (ImGuiWrapConfig::dynamicGlyphs_).
+//
+// ImGui rasterizes every glyph in a font's ranges into the atlas when it is built, so a CJK
+// font loaded with the full Chinese ranges costs tens of thousands of glyphs, tens of
+// megabytes of texture and a long build at startup, even if only a few hundred glyphs are
+// ever shown. With dynamicGlyphs_ the atlas starts out with ASCII and the characters ImGui
+// uses for fallbacks and ellipses. Every other codepoint in the requested ranges gets a
+// placeholder glyph that draws nothing, but whose texture coordinates identify it. After
+// each frame imgui_main looks for placeholders in the draw commands that use the atlas
+// texture and, if there are any, rebuilds the atlas between frames with those glyphs added
+// and uploads it again; they are drawn from the next frame on. Font files are memory
+// mapped, so only the parts that are used are read.
+//
+// Rebuilding repacks the atlas, so the whole texture is uploaded rather than a dirty
+// region; it only holds the glyphs in use, so that is small. ImGui can only pack an atlas
+// as a whole, so there is no cheaper way to add a glyph. Once every requested codepoint has
+// been drawn, the scan is skipped. Placeholders are as wide as
+// the fallback character (or an em, for East Asian wide characters), so text can shift
+// slightly in the frame a glyph appears.
+
+#include "imgui.h"
+
+#include <cstddef>
+
+struct ImGuiWrapFont;
+
+namespace dear
+{
+    // GlyphStats describes the font atlas built by imgui_main.
+    struct GlyphStats
+    {
+        // dynamic_ is true when glyphs are being rasterized as they are used.
+        bool dynamic_{false};
+
+        // rasterized_ counts the glyphs in the atlas, placeholders_ the codepoints that
+        // will be added when they are first drawn.
+        size_t rasterized_{0};
+        size_t placeholders_{0};
+
+        // rebuilds_ counts the atlas builds so far; lastBuildMs_ is how long the last one
+        // took.
+        int   rebuilds_{0};
+        float lastBuildMs_{0.0F};
+
+        int atlasWidth_{0};
+        int atlasHeight_{0};
+    };
+
+    extern GlyphStats GetGlyphStats() noexcept;
+
+    namespace detail
+    {
+        // FontsLoad adds 'count' fonts to the atlas, building it with only the glyphs that
+        // are needed up front when 'dynamic' is set.
+        extern void FontsLoad(ImFontAtlas* atlas, const ImGuiWrapFont* fonts, int count,
+                              bool dynamic) noexcept;
+
+        // FontsScan looks for placeholder glyphs in the frame's draw data, after
+        // ImGui::Render, and returns true if the atlas needs rebuilding. It returns
+        // straight away when there are no placeholders left.
+        extern bool FontsScan() noexcept;
+
+        // FontsRebuild rebuilds the atlas with the newly used glyphs; call it between
+        // frames and then recreate the renderer's font texture.
+        extern void FontsRebuild() noexcept;
+
+        // FontsGeneration counts dynamic atlas rebuilds, so that anything holding on to
+        // texture coordinates can tell when they have moved.
+        extern int FontsGeneration() noexcept;
+
+        // FontsStop releases the font files, after the atlas has been destroyed.
+        extern void FontsStop() noexcept;
+    }  // namespace detail
+}  // namespace dear
@@ -13,6 +13,23 @@
 using ImGuiWrapperReturnType = std::optional<int>;
 using ImGuiWrapperFn         = std::function<ImGuiWrapperReturnType()>;
 
+// ImGuiWrapFont describes a font for ImGuiWrapConfig::fonts_.
+struct ImGuiWrapFont
+{
+    // path_ is the TrueType/OpenType file to load, and sizePixels_ the size to rasterize it at.
+    const char* path_{nullptr};
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    float sizePixels_{13.0F};
+
+    // glyphRanges_ is a zero-terminated list of inclusive codepoint ranges, such as the
+    // static tables returned by ImFontAtlas::GetGlyphRangesJapanese(); null means
+    // ImGui's default (Basic Latin and Latin-1 Supplement).
+    const ImWchar* glyphRanges_{nullptr};
+
+    // mergeMode_ adds the glyphs to the previous font instead of creating a new one.
+    bool mergeMode_{false};
+};
+
 // ImGuiWrapConfig describes the parameters of the main window created by imgui_main.
 struct ImGuiWrapConfig
 {
@@ -40,6 +57,84 @@ struct ImGuiWrapConfig
     // startDark_ enables StyleColorsDark after creating the window.
     bool startDark_{true};
 
+    // poolAllocator_ routes ImGui's internal allocations through imguiwrap's size-class
+    // pool allocator instead of malloc. See imguiwrap.alloc.h and dear::GetAllocatorStats.
+    bool poolAllocator_{false};
+
+    // poolHugePages_ asks the pool allocator to back its slabs with huge pages where the OS
+    // permits it, falling back to regular pages otherwise.
+    bool poolHugePages_{false};
+
+    // allocCheckWarmupFrames_ enables the steady-state allocation checker when imguiwrap is
+    // built with the IMGUIWRAP_ALLOC_CHECKER cmake option: once this many frames have run,
+    // any heap allocation made on the UI thread during a frame is reported, attributed to
+    // the innermost dear:: scope. Zero disables the check.
+    int allocCheckWarmupFrames_{0};
+
+    // allocCheckAssert_ makes the checker IM_ASSERT at the offending allocation instead of
+    // logging a summary to stderr at the end of the frame.
+    bool allocCheckAssert_{false};
+
+    // asyncSettings_ moves imgui.ini handling off the UI thread: the settings are loaded via
+    // a memory mapping at startup and, when ImGui wants them saved, captured in memory and
+    // written by a background thread. See imguiwrap.settings.h.
+    bool asyncSettings_{false};
+
+    // settingsPath_ is the settings file used with asyncSettings_. As with io.IniFilename,
+    // nullptr means settings are neither loaded nor saved.
+    const char* settingsPath_{"imgui.ini"};
+
+    // taskBudgetMs_ limits how long imgui_main spends resuming suspended dear::Task
+    // coroutines each frame, when built with coroutine support. See imguiwrap.task.h.
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    float taskBudgetMs_{4.0F};
+
+    // memoEvictFrames_ is how many frames a dear::Memo value can go unused before it is
+    // destroyed. See imguiwrap.memo.h.
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    int memoEvictFrames_{120};
+
+    // mergeDrawCommands_ runs a pass after ImGui::Render that drops empty or off-screen draw
+    // commands and merges compatible adjacent ones, to reduce the number of draw calls.
+    // See imguiwrap.drawmerge.h and dear::GetDrawMergeStats.
+    bool mergeDrawCommands_{false};
+
+    // measureLatency_ timestamps input events and measures how long the frames they affect
+    // take to reach the screen. See imguiwrap.latency.h and dear::GetInputLatency.
+    bool measureLatency_{false};
+
+    // lowLatency_ paces frames, when enableVsync_ is on, so that events are polled and the
+    // frame is started just before the predicted refresh deadline rather than straight after
+    // the previous swap. It implies measureLatency_.
+    bool lowLatency_{false};
+
+    // lowLatencyMarginMs_ is how much slack lowLatency_ leaves before the deadline, on top of
+    // the time recent frames took.
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    float lowLatencyMarginMs_{2.0F};
+
+    // fonts_ points to fontCount_ fonts to load instead of ImGui's built-in font; the first
+    // is the default font. See imguiwrap.fonts.h.
+    const ImGuiWrapFont* fonts_{nullptr};
+    int                  fontCount_{0};
+
+    // dynamicGlyphs_ rasterizes the glyphs of fonts_ the first time they are drawn rather
+    // than all at startup, so that fonts with large character sets (CJK, symbols) load
+    // quickly and keep a small atlas. See dear::GetGlyphStats.
+    bool dynamicGlyphs_{false};
+
+    // compactAfterSeconds_ is how long a window or table can go unused before ImGui frees
+    // its transient buffers (io.ConfigMemoryCompactTimer); negative disables compaction.
+    // See imguiwrap.memory.h and dear::GetMemoryReport.
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    float compactAfterSeconds_{60.0F};
+
+    // releaseIdleSeconds_, if positive, is how long a window or table can go unused before
+    // imgui_main releases the state ImGui would otherwise keep for good: the window's
+    // ImGuiStorage (tree node open state, etc) and the table, which comes back from its
+    // saved settings.
+    float releaseIdleSeconds_{0.0F};
+
 #ifdef IMGUI_HAS_DOCK
 	// enableDocking_ enables windows to dock with each other
 	bool enableDocking_{false};
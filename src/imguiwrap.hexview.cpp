@@ -0,0 +1,448 @@
+#include "imguiwrap.hexview.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define IMGUIWRAP_HEXVIEW_SSE2
+#    include <emmintrin.h>
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#    endif
+#endif
+
+namespace
+{
+    // The background search scans this much at a time between progress updates.
+    constexpr size_t SearchChunk = size_t{64} << 20U;
+
+    // Bytes per hex group; groups are separated by an extra space.
+    constexpr int GroupSize = 8;
+
+    constexpr int ScrollLinesPerWheel = 3;
+
+#ifdef IMGUIWRAP_HEXVIEW_SSE2
+    inline unsigned
+    lowestBit(unsigned mask) noexcept
+    {
+#    if defined(_MSC_VER)
+        unsigned long index{0};
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#    else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#    endif
+    }
+#endif
+
+    int
+    hexDigit(char c) noexcept
+    {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f') {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'F') {
+            return c - 'A' + 10;
+        }
+        return -1;
+    }
+
+    // parseHex turns "7f 45 4c46" into bytes, returning false on anything else.
+    bool
+    parseHex(const char* text, std::vector<uint8_t>& out) noexcept
+    {
+        out.clear();
+        int high = -1;
+        for (; *text != '\0'; ++text) {
+            if (*text == ' ' || *text == '\t') {
+                continue;
+            }
+            const int digit = hexDigit(*text);
+            if (digit < 0) {
+                return false;
+            }
+            if (high < 0) {
+                high = digit;
+            } else {
+                out.push_back(static_cast<uint8_t>((high << 4) | digit));
+                high = -1;
+            }
+        }
+        return high < 0 && !out.empty();
+    }
+
+}  // namespace
+
+namespace dear
+{
+    HexView::~HexView() { CancelSearch(); }
+
+    void HexView::reset() noexcept
+    {
+        CancelSearch();
+        result_.reset();
+        highlights_.clear();
+        topRow_ = 0;
+        cursor_ = npos;
+        scrollTo_.reset();
+    }
+
+    bool HexView::Open(const char* path) noexcept
+    {
+        reset();
+        data_ = nullptr;
+        size_ = 0;
+        if (!file_.Open(path)) {
+            return false;
+        }
+        data_ = file_.Data();
+        size_ = file_.Size();
+        return true;
+    }
+
+    void HexView::SetData(const uint8_t* data, size_t size) noexcept
+    {
+        reset();
+        file_.Close();
+        data_ = data;
+        size_ = size;
+    }
+
+    void HexView::AddHighlight(size_t offset, size_t length, ImU32 color) noexcept
+    {
+        if (length > 0) {
+            highlights_.push_back(Highlight{offset, offset + length, color});
+        }
+    }
+
+    size_t HexView::FindPattern(const uint8_t* data, size_t size, const uint8_t* pattern,
+                                size_t length) noexcept
+    {
+        if (length == 0 || length > size) {
+            return npos;
+        }
+        if (length == 1) {
+            const void* hit = memchr(data, pattern[0], size);
+            return hit != nullptr ? static_cast<size_t>(static_cast<const uint8_t*>(hit) - data)
+                                  : npos;
+        }
+
+        const size_t last = length - 1;
+        size_t       pos  = 0;
+#ifdef IMGUIWRAP_HEXVIEW_SSE2
+        // Each block tests 16 candidate starts at once: a candidate survives if both its
+        // first and last bytes match, and only survivors are compared in full.
+        const __m128i firstByte = _mm_set1_epi8(static_cast<char>(pattern[0]));
+        const __m128i lastByte = _mm_set1_epi8(static_cast<char>(pattern[last]));
+        for (; pos + 16 + last <= size; pos += 16) {
+            const auto* head = reinterpret_cast<const __m128i*>(data + pos);
+            const auto* tail = reinterpret_cast<const __m128i*>(data + pos + last);
+            const __m128i match =
+                _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128(head), firstByte),
+                              _mm_cmpeq_epi8(_mm_loadu_si128(tail), lastByte));
+            auto mask = static_cast<unsigned>(_mm_movemask_epi8(match));
+            while (mask != 0) {
+                const size_t candidate = pos + lowestBit(mask);
+                if (memcmp(data + candidate + 1, pattern + 1, length - 2) == 0) {
+                    return candidate;
+                }
+                mask &= mask - 1;
+            }
+        }
+#endif
+        // Remainder (or everything, without SSE2): libc's memchr for the first byte.
+        while (pos + length <= size) {
+            const void* hit = memchr(data + pos, pattern[0], size - last - pos);
+            if (hit == nullptr) {
+                break;
+            }
+            const auto candidate = static_cast<size_t>(static_cast<const uint8_t*>(hit) - data);
+            if (memcmp(data + candidate, pattern, length) == 0) {
+                return candidate;
+            }
+            pos = candidate + 1;
+        }
+        return npos;
+    }
+
+    void HexView::Find(const uint8_t* pattern, size_t length, size_t from) noexcept
+    {
+        CancelSearch();
+        result_.reset();
+        if (data_ == nullptr || length == 0 || from >= size_) {
+            return;
+        }
+        pattern_.assign(pattern, pattern + length);
+        searchFrom_ = from;
+        scanned_.store(0, std::memory_order_relaxed);
+        found_.store(npos, std::memory_order_relaxed);
+        cancel_.store(false, std::memory_order_relaxed);
+        searching_.store(true, std::memory_order_release);
+        collected_ = false;
+        searcher_  = std::thread([this] { searchThread(); });
+    }
+
+    void HexView::CancelSearch() noexcept
+    {
+        cancel_.store(true, std::memory_order_relaxed);
+        if (searcher_.joinable()) {
+            searcher_.join();
+        }
+        searching_.store(false, std::memory_order_release);
+        collected_ = true;
+    }
+
+    float HexView::SearchProgress() const noexcept
+    {
+        const size_t total = size_ > searchFrom_ ? size_ - searchFrom_ : 0;
+        if (total == 0) {
+            return 1.0F;
+        }
+        return static_cast<float>(static_cast<double>(scanned_.load(std::memory_order_relaxed)) /
+                                  static_cast<double>(total));
+    }
+
+    void HexView::searchThread() noexcept
+    {
+        const size_t overlap = pattern_.size() - 1;
+        for (size_t pos = searchFrom_; pos < size_; pos += SearchChunk) {
+            if (cancel_.load(std::memory_order_relaxed)) {
+                break;
+            }
+            // Chunks overlap so that matches straddling a boundary are found.
+            const size_t end = std::min(size_, pos + SearchChunk + overlap);
+            const size_t hit =
+                FindPattern(data_ + pos, end - pos, pattern_.data(), pattern_.size());
+            if (hit != npos) {
+                found_.store(pos + hit, std::memory_order_relaxed);
+                break;
+            }
+            scanned_.store(std::min(size_, pos + SearchChunk) - searchFrom_,
+                           std::memory_order_relaxed);
+        }
+        searching_.store(false, std::memory_order_release);
+    }
+
+    void HexView::pollSearch() noexcept
+    {
+        if (collected_ || Searching()) {
+            return;
+        }
+        searcher_.join();
+        collected_ = true;
+        if (const size_t found = found_.load(std::memory_order_relaxed); found != npos) {
+            result_   = found;
+            cursor_   = found;
+            scrollTo_ = found;
+        }
+    }
+
+    void HexView::drawToolbar() noexcept
+    {
+        bool find = false, next = false;
+        ImGui::SetNextItemWidth(ImGui::GetFontSize() * 16.0F);
+        find = ImGui::InputTextWithHint("##find", "hex bytes, e.g. 7f 45 4c 46", findBuffer_,
+                                        sizeof(findBuffer_),
+                                        ImGuiInputTextFlags_EnterReturnsTrue);
+        ImGui::SameLine();
+        find |= ImGui::Button("Find");
+        ImGui::SameLine();
+        next = ImGui::Button("Next");
+
+        if (find || next) {
+            std::vector<uint8_t> pattern;
+            findInvalid_ = !parseHex(findBuffer_, pattern);
+            if (!findInvalid_) {
+                const size_t from = (next && result_.has_value()) ? *result_ + 1 : 0;
+                Find(pattern.data(), pattern.size(), from);
+            }
+        }
+
+        ImGui::SameLine();
+        if (Searching()) {
+            if (ImGui::Button("Cancel")) {
+                CancelSearch();
+            }
+            ImGui::SameLine();
+            ImGui::ProgressBar(SearchProgress(), ImVec2(-FLT_MIN, 0.0F));
+        } else if (findInvalid_) {
+            ImGui::TextDisabled("invalid pattern");
+        } else if (result_.has_value()) {
+            ImGui::TextDisabled("found at 0x%llX", static_cast<unsigned long long>(*result_));
+        } else if (!pattern_.empty()) {
+            ImGui::TextDisabled("not found");
+        }
+    }
+
+    void HexView::drawRows(const ImVec2& region) noexcept
+    {
+        const ImGuiStyle& style      = ImGui::GetStyle();
+        const float       lineHeight = ImGui::GetTextLineHeight();
+        const float       charWidth  = ImGui::CalcTextSize("0").x;
+        const auto        perRow     = static_cast<size_t>(bytesPerRow_);
+
+        const uint64_t totalRows   = (size_ + perRow - 1) / perRow;
+        const auto     visibleRows = static_cast<uint64_t>(std::max(1.0F, region.y / lineHeight));
+        const uint64_t maxTop      = totalRows > visibleRows ? totalRows - visibleRows : 0;
+
+        if (scrollTo_.has_value()) {
+            const uint64_t row = *scrollTo_ / perRow;
+            if (row < topRow_ || row >= topRow_ + visibleRows) {
+                topRow_ = row > visibleRows / 2 ? row - visibleRows / 2 : 0;
+            }
+            scrollTo_.reset();
+        }
+
+        // Column layout, in characters: offset, hex bytes in groups, ASCII.
+        const int   offsetDigits = size_ > 0xFFFFFFFFULL ? 16 : 8;
+        const float hexStart     = static_cast<float>(offsetDigits + 2) * charWidth;
+        const auto  hexX         = [&](size_t column) {
+            return hexStart + static_cast<float>(column * 3 + column / GroupSize) * charWidth;
+        };
+        const float asciiStart = hexX(perRow) + charWidth;
+
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        const ImVec2 rowsSize(region.x - style.ScrollbarSize - style.ItemSpacing.x, region.y);
+        ImGui::InvisibleButton("##rows", rowsSize);
+
+        if (ImGui::IsItemHovered()) {
+            const float wheel = ImGui::GetIO().MouseWheel;
+            if (wheel > 0.0F) {
+                const auto lines = static_cast<uint64_t>(wheel * ScrollLinesPerWheel);
+                topRow_          = topRow_ > lines ? topRow_ - lines : 0;
+            } else if (wheel < 0.0F) {
+                topRow_ += static_cast<uint64_t>(-wheel * ScrollLinesPerWheel);
+            }
+        }
+        if (ImGui::IsWindowFocused(ImGuiFocusedFlags_ChildWindows)) {
+            if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_PageUp))) {
+                topRow_ = topRow_ > visibleRows ? topRow_ - visibleRows : 0;
+            }
+            if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_PageDown))) {
+                topRow_ += visibleRows;
+            }
+        }
+        topRow_ = std::min(topRow_, maxTop);
+
+        if (ImGui::IsItemClicked()) {
+            const ImVec2   mouse  = ImGui::GetMousePos();
+            const auto     line   = static_cast<uint64_t>((mouse.y - origin.y) / lineHeight);
+            const uint64_t row    = topRow_ + line;
+            const float    x      = mouse.x - origin.x;
+            size_t         column = perRow;
+            if (x >= asciiStart) {
+                column = static_cast<size_t>((x - asciiStart) / charWidth);
+            } else {
+                for (size_t c = 0; c < perRow; ++c) {
+                    if (x >= hexX(c) && x < hexX(c) + charWidth * 2) {
+                        column = c;
+                        break;
+                    }
+                }
+            }
+            if (column < perRow && row * perRow + column < size_) {
+                cursor_ = row * perRow + column;
+            }
+        }
+
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        drawList->PushClipRect(origin, ImVec2(origin.x + rowsSize.x, origin.y + rowsSize.y), true);
+
+        const ImU32 textColor   = ImGui::GetColorU32(ImGuiCol_Text);
+        const ImU32 offsetColor = ImGui::GetColorU32(ImGuiCol_TextDisabled);
+        const ImU32 selectColor = ImGui::GetColorU32(ImGuiCol_TextSelectedBg);
+
+        // highlightRange shades [begin, end) on one row, in both the hex and ASCII columns.
+        const auto highlightRange = [&](float y, size_t rowStart, size_t begin, size_t end,
+                                        ImU32 color) {
+            const size_t first = begin - rowStart, last = end - rowStart - 1;
+            drawList->AddRectFilled(ImVec2(origin.x + hexX(first), y),
+                                    ImVec2(origin.x + hexX(last) + charWidth * 2, y + lineHeight),
+                                    color);
+            drawList->AddRectFilled(
+                ImVec2(origin.x + asciiStart + static_cast<float>(first) * charWidth, y),
+                ImVec2(origin.x + asciiStart + static_cast<float>(last + 1) * charWidth,
+                       y + lineHeight),
+                color);
+        };
+
+        line_.resize(perRow * 4 + 32);
+        for (uint64_t r = 0; r < visibleRows && topRow_ + r < totalRows; ++r) {
+            const size_t rowStart = (topRow_ + r) * perRow;
+            const size_t rowEnd   = std::min(size_, rowStart + perRow);
+            const float  y        = origin.y + static_cast<float>(r) * lineHeight;
+
+            for (const Highlight& h : highlights_) {
+                if (h.end_ > rowStart && h.begin_ < rowEnd) {
+                    highlightRange(y, rowStart, std::max(h.begin_, rowStart),
+                                   std::min(h.end_, rowEnd), h.color_);
+                }
+            }
+            if (result_.has_value() && *result_ < rowEnd &&
+                *result_ + pattern_.size() > rowStart) {
+                highlightRange(y, rowStart, std::max(*result_, rowStart),
+                               std::min(*result_ + pattern_.size(), rowEnd), selectColor);
+            }
+            if (cursor_ >= rowStart && cursor_ < rowEnd) {
+                highlightRange(y, rowStart, cursor_, cursor_ + 1, selectColor);
+            }
+
+            char offset[20];
+            (void) snprintf(offset, sizeof(offset), "%0*llX", offsetDigits,
+                            static_cast<unsigned long long>(rowStart));
+            drawList->AddText(ImVec2(origin.x, y), offsetColor, offset);
+
+            // Hex column, with a space between bytes and an extra one between groups.
+            static constexpr char Digits[] = "0123456789ABCDEF";
+            char*                 out      = line_.data();
+            for (size_t i = rowStart; i < rowEnd; ++i) {
+                const size_t column = i - rowStart;
+                if (column > 0) {
+                    *out++ = ' ';
+                    if (column % GroupSize == 0) {
+                        *out++ = ' ';
+                    }
+                }
+                *out++ = Digits[data_[i] >> 4U];
+                *out++ = Digits[data_[i] & 0xFU];
+            }
+            drawList->AddText(ImVec2(origin.x + hexStart, y), textColor, line_.data(), out);
+
+            out = line_.data();
+            for (size_t i = rowStart; i < rowEnd; ++i) {
+                *out++ = (data_[i] >= 0x20 && data_[i] < 0x7F) ? static_cast<char>(data_[i]) : '.';
+            }
+            drawList->AddText(ImVec2(origin.x + asciiStart, y), textColor, line_.data(), out);
+        }
+        drawList->PopClipRect();
+
+        // The scrollbar: top of the slider is the start of the data.
+        ImGui::SameLine();
+        const uint64_t top = 0;
+        ImGui::VSliderScalar("##scroll", ImVec2(style.ScrollbarSize, region.y),
+                             ImGuiDataType_U64, &topRow_, &maxTop, &top, "");
+    }
+
+    void HexView::Draw(const char* str_id, const ImVec2& size) noexcept
+    {
+        ImGui::PushID(str_id);
+        pollSearch();
+        drawToolbar();
+
+        constexpr ImGuiWindowFlags flags =
+            ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoScrollWithMouse;
+        dear::Child(str_id, size, false, flags) && [&] {
+            if (data_ == nullptr) {
+                ImGui::TextDisabled("no data");
+                return;
+            }
+            drawRows(ImGui::GetContentRegionAvail());
+        };
+        ImGui::PopID();
+    }
+}  // namespace dear
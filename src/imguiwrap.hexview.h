@@ -0,0 +1,127 @@
+#pragma once
+
+#include "imguiwrap.dear.h"
+#include "imguiwrap.mappedfile.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace dear
+{
+    // HexView is a hex/ASCII viewer for large binary data: a memory-mapped file (see Open)
+    // or a caller-owned span (see SetData).
+    //
+    // - Only the visible rows are read and drawn. Scrolling is tracked as a 64-bit row
+    //   number with its own scrollbar, since ImGui's float scroll positions lose precision
+    //   long before the end of a multi-GB file,
+    // - Ranges can be highlighted with a color,
+    // - Byte patterns are searched for on a background thread (see FindPattern for the
+    //   scan itself), with progress shown in the toolbar; the match is highlighted and
+    //   scrolled to when the search finishes.
+    //
+    //   static dear::HexView view;
+    //   if (!view.IsOpen()) view.Open("capture.bin");
+    //   dear::Begin("Capture") && [] { view.Draw("##capture"); };
+    class HexView
+    {
+    public:
+        static constexpr size_t npos = ~size_t{0};
+
+        HexView() noexcept = default;
+        ~HexView();
+
+        HexView(const HexView&) = delete;
+        HexView& operator=(const HexView&) = delete;
+
+        // Open maps a file for viewing, returning false if it couldn't be mapped.
+        bool Open(const char* path) noexcept;
+
+        // SetData views memory owned by the caller, which must outlive the view (or the
+        // next SetData/Open).
+        void SetData(const uint8_t* data, size_t size) noexcept;
+
+        bool           IsOpen() const noexcept { return data_ != nullptr; }
+        const uint8_t* Data() const noexcept { return data_; }
+        size_t         Size() const noexcept { return size_; }
+
+        // Draw presents the toolbar (search) and the visible rows in a child region of the
+        // given size.
+        void Draw(const char* str_id, const ImVec2& size = Zero) noexcept;
+
+        // BytesPerRow defaults to 16.
+        void SetBytesPerRow(int bytes) noexcept { bytesPerRow_ = bytes > 0 ? bytes : 1; }
+
+        // ScrollTo brings an offset into view on the next Draw.
+        void ScrollTo(size_t offset) noexcept { scrollTo_ = offset; }
+
+        // Cursor is the last byte clicked on (or found), or npos.
+        size_t Cursor() const noexcept { return cursor_; }
+
+        // Highlights are drawn behind the bytes in [offset, offset + length).
+        void AddHighlight(size_t offset, size_t length, ImU32 color) noexcept;
+        void ClearHighlights() noexcept { highlights_.clear(); }
+
+        // Find starts a background search for 'pattern' from 'from', cancelling any search
+        // in progress.
+        void Find(const uint8_t* pattern, size_t length, size_t from = 0) noexcept;
+        void CancelSearch() noexcept;
+
+        // Searching is true while a search runs; SearchProgress is the fraction scanned.
+        bool  Searching() const noexcept { return searching_.load(std::memory_order_acquire); }
+        float SearchProgress() const noexcept;
+
+        // SearchResult is the offset of the last completed search's match, if any.
+        std::optional<size_t> SearchResult() const noexcept { return result_; }
+
+        // FindPattern returns the offset of the first occurrence of 'pattern' in 'data', or
+        // npos. It uses SSE2 where available: candidate positions are found by comparing 16
+        // bytes at a time against the pattern's first and last bytes, and only those are
+        // compared in full.
+        static size_t FindPattern(const uint8_t* data, size_t size, const uint8_t* pattern,
+                                  size_t length) noexcept;
+
+    private:
+        struct Highlight
+        {
+            size_t begin_;
+            size_t end_;
+            ImU32  color_;
+        };
+
+        void reset() noexcept;
+        void drawToolbar() noexcept;
+        void drawRows(const ImVec2& size) noexcept;
+        void searchThread() noexcept;
+        void pollSearch() noexcept;
+
+        MappedFile     file_;
+        const uint8_t* data_{nullptr};
+        size_t         size_{0};
+
+        int                   bytesPerRow_{16};
+        uint64_t              topRow_{0};
+        std::optional<size_t> scrollTo_;
+        size_t                cursor_{npos};
+
+        std::vector<Highlight> highlights_;
+        std::vector<char>      line_;  // text of the row being drawn
+
+        // Search state; the thread only reads pattern_/data_ and writes the atomics.
+        std::thread           searcher_;
+        std::vector<uint8_t>  pattern_;
+        size_t                searchFrom_{0};
+        std::atomic<bool>     searching_{false};
+        std::atomic<bool>     cancel_{false};
+        std::atomic<size_t>   scanned_{0};
+        std::atomic<size_t>   found_{npos};
+        bool                  collected_{true};
+        std::optional<size_t> result_;
+
+        char findBuffer_[128]{};
+        bool findInvalid_{false};
+    };
+}  // namespace dear
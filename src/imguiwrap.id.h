@@ -0,0 +1,107 @@
+#pragma once
+
+#include "imgui.h"
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+// Compile-time equivalents of ImGui's ID hashing, so that IDs for literal labels can be
+// computed by the compiler rather than hashed on every call.
+
+#if defined(__cpp_consteval)
+#    define IMGUIWRAP_CONSTEVAL consteval
+#else
+#    define IMGUIWRAP_CONSTEVAL constexpr
+#endif
+
+namespace dear
+{
+    // ID is an ImGuiID computed ahead of time, as opposed to an integer to be hashed (see
+    // dear::WithID).
+    struct ID
+    {
+        ImGuiID value_{0};
+
+        constexpr ID() noexcept = default;
+        constexpr explicit ID(ImGuiID value) noexcept : value_{value} {}
+        constexpr operator ImGuiID() const noexcept { return value_; }
+    };
+
+    namespace detail
+    {
+        // The same CRC32 table (polynomial 0xEDB88320) that ImGui uses.
+        constexpr std::array<ImU32, 256> MakeCrc32Table() noexcept
+        {
+            std::array<ImU32, 256> table{};
+            for (ImU32 i = 0; i < 256; ++i) {
+                ImU32 crc = i;
+                for (int bit = 0; bit < 8; ++bit) {
+                    crc = (crc & 1U) ? (crc >> 1U) ^ 0xEDB88320U : crc >> 1U;
+                }
+                table[i] = crc;
+            }
+            return table;
+        }
+
+        inline constexpr std::array<ImU32, 256> Crc32Table = MakeCrc32Table();
+
+        constexpr ImU32 Crc32Step(ImU32 crc, unsigned char c) noexcept
+        {
+            return (crc >> 8U) ^ Crc32Table[(crc & 0xFFU) ^ c];
+        }
+    }  // namespace detail
+
+    // HashID returns the ID ImGui would give 'label' when the top of the ID stack is
+    // 'seed', i.e. ImHashStr(label, size, seed), including the rule that "###" restarts
+    // the hash from the seed.
+    //
+    // Top-level windows are seeded with 0, so the ID of a button "OK" in window "Main" is
+    // HashID("OK", HashID("Main")), and a PushID("row") within it adds another link.
+    constexpr ID HashID(std::string_view label, ID seed = ID{}) noexcept
+    {
+        const ImU32 start = ~seed.value_;
+        ImU32       crc   = start;
+        for (size_t i = 0; i < label.size(); ++i) {
+            const auto c = static_cast<unsigned char>(label[i]);
+            if (c == '#' && i + 2 < label.size() && label[i + 1] == '#' && label[i + 2] == '#') {
+                crc = start;
+            }
+            crc = detail::Crc32Step(crc, c);
+        }
+        return ID{~crc};
+    }
+
+    // HashID for an integer matches ImGui::PushID(int)/GetID(int), which hash the bytes of
+    // the int as they are laid out in memory.
+    constexpr ID HashID(int n, ID seed = ID{}) noexcept
+    {
+        const auto bits = static_cast<ImU32>(n);
+        ImU32      crc  = ~seed.value_;
+        for (size_t i = 0; i < sizeof(n); ++i) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            const size_t shift = (sizeof(n) - 1 - i) * 8;
+#else
+            const size_t shift = i * 8;
+#endif
+            crc = detail::Crc32Step(crc, static_cast<unsigned char>(bits >> shift));
+        }
+        return ID{~crc};
+    }
+
+    // With a zero seed, ImHashStr is plain CRC32.
+    static_assert(HashID("123456789").value_ == 0xCBF43926U);
+
+    namespace literals
+    {
+        // "label"_id is the unseeded ID of a label, evaluated at compile time (guaranteed
+        // with C++20, where it is consteval), e.g. for a top-level window's ID:
+        //
+        //   using namespace dear::literals;
+        //   constexpr dear::ID settingsWindow = "Settings"_id;
+        IMGUIWRAP_CONSTEVAL ID operator""_id(const char* label, size_t length) noexcept
+        {
+            return HashID(std::string_view(label, length));
+        }
+    }  // namespace literals
+}  // namespace dear
@@ -0,0 +1,385 @@
+// Input-to-photon latency measurement and low-latency frame pacing; see imguiwrap.latency.h.
+
+#include "imguiwrap.latency.h"
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+// GL entry points use the system calling convention, which only differs on 32-bit Windows.
+#ifdef _WIN32
+#    define IMGUIWRAP_GLAPI __stdcall
+#else
+#    define IMGUIWRAP_GLAPI
+#endif
+
+namespace
+{
+    using Clock     = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+
+    // The sync object API (GL 3.2 / ARB_sync) isn't part of the loader imgui ships, so it
+    // is looked up through GLFW. GLsync is an opaque pointer.
+    using Sync             = void*;
+    using FenceSyncFn      = Sync(IMGUIWRAP_GLAPI*)(unsigned int condition, unsigned int flags);
+    using ClientWaitSyncFn = unsigned int(IMGUIWRAP_GLAPI*)(Sync sync, unsigned int flags,
+                                                            uint64_t timeoutNs);
+    using DeleteSyncFn     = void(IMGUIWRAP_GLAPI*)(Sync sync);
+
+    constexpr unsigned int SyncGpuCommandsComplete = 0x9117;  // GL_SYNC_GPU_COMMANDS_COMPLETE
+    constexpr unsigned int SyncFlushCommandsBit    = 0x0001;  // GL_SYNC_FLUSH_COMMANDS_BIT
+    constexpr unsigned int AlreadySignaled         = 0x911A;  // GL_ALREADY_SIGNALED
+    constexpr unsigned int ConditionSatisfied      = 0x911C;  // GL_CONDITION_SATISFIED
+
+    // Refresh rate to assume when the monitor doesn't report one.
+    constexpr int DefaultRefreshHz = 60;
+
+    // Frames whose duration is used to predict the next one.
+    constexpr size_t WorkHistory = 32;
+
+    // Fences outstanding at once when not pacing; more than this and the oldest is dropped.
+    constexpr size_t MaxPendingFences = 4;
+
+    float
+    toMs(Clock::duration duration) noexcept
+    {
+        return std::chrono::duration<float, std::milli>(duration).count();
+    }
+
+    // SampleRing keeps the most recent LatencySamples measurements.
+    class SampleRing
+    {
+    public:
+        void Add(float ms) noexcept
+        {
+            samples_[next_] = ms;
+            next_           = (next_ + 1) % samples_.size();
+            count_          = std::min(count_ + 1, samples_.size());
+        }
+
+        void Clear() noexcept { count_ = next_ = 0; }
+
+        size_t Count() const noexcept { return count_; }
+
+        dear::LatencyPercentiles Percentiles() const noexcept
+        {
+            dear::LatencyPercentiles result{};
+            if (count_ == 0) {
+                return result;
+            }
+            std::array<float, dear::LatencySamples> sorted;
+            std::copy_n(samples_.begin(), count_, sorted.begin());
+            std::sort(sorted.begin(), sorted.begin() + static_cast<ptrdiff_t>(count_));
+            // Nearest-rank percentiles.
+            const auto rank = [&sorted, this](double percentile) noexcept {
+                const auto index = static_cast<size_t>(std::ceil(percentile * count_));
+                return sorted[std::clamp<size_t>(index, 1, count_) - 1];
+            };
+            result.p50Ms_ = rank(0.50);
+            result.p90Ms_ = rank(0.90);
+            result.p99Ms_ = rank(0.99);
+            result.maxMs_ = sorted[count_ - 1];
+            return result;
+        }
+
+    private:
+        std::array<float, dear::LatencySamples> samples_{};
+        size_t                                  count_{0};
+        size_t                                  next_{0};
+    };
+
+    struct PendingFence
+    {
+        Sync      fence_;
+        TimePoint input_;
+    };
+
+    // LatencyState is only used from the UI thread (GLFW delivers events on it).
+    struct LatencyState
+    {
+        bool active_{false};
+        bool lowLatency_{false};
+
+        FenceSyncFn      fenceSync_{nullptr};
+        ClientWaitSyncFn clientWaitSync_{nullptr};
+        DeleteSyncFn     deleteSync_{nullptr};
+
+        // Input seen since the last poll, and input consumed by the frame being built.
+        bool      inputPending_{false};
+        TimePoint earliestInput_{};
+        bool      frameHasInput_{false};
+        TimePoint frameInput_{};
+
+        // Pacing: when the current frame started, when the last one completed, and how long
+        // recent frames took from start to completion.
+        TimePoint                                frameStart_{};
+        TimePoint                                lastDone_{};
+        bool                                     havePhase_{false};
+        Clock::duration                          period_{};
+        Clock::duration                          margin_{};
+        std::array<Clock::duration, WorkHistory> work_{};
+        size_t                                   workNext_{0};
+
+        std::array<PendingFence, MaxPendingFences> fences_{};
+        size_t                                     fenceCount_{0};
+
+        SampleRing toSwap_;
+        SampleRing toGpu_;
+
+        bool HasFences() const noexcept
+        {
+            return fenceSync_ != nullptr && clientWaitSync_ != nullptr && deleteSync_ != nullptr;
+        }
+
+        Clock::duration WorkEstimate() const noexcept
+        {
+            return *std::max_element(work_.begin(), work_.end());
+        }
+    };
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    LatencyState latency;
+
+    void
+    noteInput() noexcept
+    {
+        if (!latency.inputPending_) {
+            latency.inputPending_  = true;
+            latency.earliestInput_ = Clock::now();
+        }
+    }
+
+    // The GLFW callbacks just note the time; ImGui's own callbacks chain to these.
+    void
+    onKey(GLFWwindow* /*window*/, int /*key*/, int /*scancode*/, int /*action*/,
+          int /*mods*/) noexcept
+    {
+        noteInput();
+    }
+
+    void
+    onChar(GLFWwindow* /*window*/, unsigned int /*codepoint*/) noexcept
+    {
+        noteInput();
+    }
+
+    void
+    onMouseButton(GLFWwindow* /*window*/, int /*button*/, int /*action*/, int /*mods*/) noexcept
+    {
+        noteInput();
+    }
+
+    void
+    onCursorPos(GLFWwindow* /*window*/, double /*x*/, double /*y*/) noexcept
+    {
+        noteInput();
+    }
+
+    void
+    onScroll(GLFWwindow* /*window*/, double /*x*/, double /*y*/) noexcept
+    {
+        noteInput();
+    }
+
+    bool
+    signaled(unsigned int result) noexcept
+    {
+        return result == AlreadySignaled || result == ConditionSatisfied;
+    }
+
+    // reapFences records the GPU latency of any outstanding fences that have completed.
+    // Completion is only observed here, so these samples are late by up to a frame.
+    void
+    reapFences() noexcept
+    {
+        size_t reaped = 0;
+        while (reaped < latency.fenceCount_) {
+            const PendingFence& pending = latency.fences_[reaped];
+            if (!signaled(latency.clientWaitSync_(pending.fence_, 0, 0))) {
+                break;
+            }
+            latency.toGpu_.Add(toMs(Clock::now() - pending.input_));
+            latency.deleteSync_(pending.fence_);
+            ++reaped;
+        }
+        std::move(latency.fences_.begin() + static_cast<ptrdiff_t>(reaped),
+                  latency.fences_.begin() + static_cast<ptrdiff_t>(latency.fenceCount_),
+                  latency.fences_.begin());
+        latency.fenceCount_ -= reaped;
+    }
+
+    void
+    queueFence(Sync fence) noexcept
+    {
+        if (latency.fenceCount_ == latency.fences_.size()) {
+            latency.deleteSync_(latency.fences_[0].fence_);
+            std::move(latency.fences_.begin() + 1, latency.fences_.end(), latency.fences_.begin());
+            --latency.fenceCount_;
+        }
+        latency.fences_[latency.fenceCount_++] = PendingFence{fence, latency.frameInput_};
+        // Make sure the fence is submitted rather than sitting in the command buffer.
+        (void) latency.clientWaitSync_(fence, SyncFlushCommandsBit, 0);
+    }
+
+    template<typename Fn>
+    Fn
+    glProc(const char* name) noexcept
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return reinterpret_cast<Fn>(glfwGetProcAddress(name));
+    }
+
+    Clock::duration
+    refreshPeriod(GLFWwindow* window) noexcept
+    {
+        GLFWmonitor* monitor = glfwGetWindowMonitor(window);
+        if (monitor == nullptr) {
+            monitor = glfwGetPrimaryMonitor();
+        }
+        const GLFWvidmode* mode = monitor != nullptr ? glfwGetVideoMode(monitor) : nullptr;
+        const int hz = mode != nullptr && mode->refreshRate > 0 ? mode->refreshRate
+                                                                : DefaultRefreshHz;
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) / hz;
+    }
+
+}  // namespace
+
+namespace dear
+{
+    LatencyStats GetInputLatency() noexcept
+    {
+        LatencyStats stats{};
+        stats.samples_    = latency.toSwap_.Count();
+        stats.gpuSamples_ = latency.toGpu_.Count();
+        stats.toSwap_     = latency.toSwap_.Percentiles();
+        stats.toGpu_      = latency.toGpu_.Percentiles();
+        stats.lowLatency_ = latency.lowLatency_;
+        if (latency.lowLatency_) {
+            stats.framePeriodMs_ = toMs(latency.period_);
+            stats.frameWorkMs_   = toMs(latency.WorkEstimate());
+        }
+        return stats;
+    }
+
+    void ResetInputLatency() noexcept
+    {
+        latency.toSwap_.Clear();
+        latency.toGpu_.Clear();
+    }
+
+    namespace detail
+    {
+        void LatencyStart(GLFWwindow* window, bool vsync, bool lowLatency, float marginMs) noexcept
+        {
+            latency.active_ = true;
+
+            latency.fenceSync_      = glProc<FenceSyncFn>("glFenceSync");
+            latency.clientWaitSync_ = glProc<ClientWaitSyncFn>("glClientWaitSync");
+            latency.deleteSync_     = glProc<DeleteSyncFn>("glDeleteSync");
+
+            if (lowLatency && !vsync) {
+                (void) fprintf(stderr, "imguiwrap: lowLatency_ needs enableVsync_, frames will "
+                                       "not be paced\n");
+            }
+            latency.lowLatency_ = lowLatency && vsync;
+            latency.period_     = refreshPeriod(window);
+            latency.margin_     = std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<float, std::milli>(std::max(marginMs, 0.0F)));
+
+            (void) glfwSetKeyCallback(window, onKey);
+            (void) glfwSetCharCallback(window, onChar);
+            (void) glfwSetMouseButtonCallback(window, onMouseButton);
+            (void) glfwSetCursorPosCallback(window, onCursorPos);
+            (void) glfwSetScrollCallback(window, onScroll);
+        }
+
+        void LatencyPollEvents(GLFWwindow* window) noexcept
+        {
+            if (!latency.active_) {
+                glfwPollEvents();
+                return;
+            }
+            if (latency.fenceCount_ > 0) {
+                reapFences();
+            }
+
+            if (latency.lowLatency_ && latency.havePhase_) {
+                // Start as late as the slowest recent frame allows, dispatching (and
+                // timestamping) events as they arrive in the meantime.
+                const TimePoint wake = latency.lastDone_ + latency.period_ -
+                                       latency.WorkEstimate() - latency.margin_;
+                for (TimePoint now = Clock::now(); now < wake && glfwWindowShouldClose(window) == 0;
+                     now           = Clock::now()) {
+                    glfwWaitEventsTimeout(std::chrono::duration<double>(wake - now).count());
+                }
+            }
+            glfwPollEvents();
+
+            latency.frameStart_    = Clock::now();
+            latency.frameHasInput_ = latency.inputPending_;
+            latency.frameInput_    = latency.earliestInput_;
+            latency.inputPending_  = false;
+        }
+
+        void LatencySwapBuffers(GLFWwindow* window) noexcept
+        {
+            if (!latency.active_) {
+                glfwSwapBuffers(window);
+                return;
+            }
+
+            // The fence goes in before the swap, so that it measures the frame's rendering
+            // and not however long the swap waits for the display.
+            TimePoint rendered = Clock::now();
+            if (latency.HasFences() && (latency.lowLatency_ || latency.frameHasInput_)) {
+                Sync fence = latency.fenceSync_(SyncGpuCommandsComplete, 0);
+                if (fence != nullptr && latency.lowLatency_) {
+                    // Waiting means frames can't queue up in the driver, and tells us exactly
+                    // when this one finished.
+                    const auto timeout =
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(latency.period_ * 4);
+                    if (signaled(latency.clientWaitSync_(fence, SyncFlushCommandsBit,
+                                                         static_cast<uint64_t>(timeout.count())))) {
+                        rendered = Clock::now();
+                        if (latency.frameHasInput_) {
+                            latency.toGpu_.Add(toMs(rendered - latency.frameInput_));
+                        }
+                    }
+                    latency.deleteSync_(fence);
+                } else if (fence != nullptr) {
+                    queueFence(fence);
+                }
+            }
+
+            glfwSwapBuffers(window);
+
+            const TimePoint swapped = Clock::now();
+            if (latency.frameHasInput_) {
+                latency.toSwap_.Add(toMs(swapped - latency.frameInput_));
+            }
+
+            // With vsync the swap returns at (or, with a free buffer, shortly before) a
+            // refresh, which gives the phase of the next deadline.
+            if (latency.lowLatency_) {
+                latency.work_[latency.workNext_] = rendered - latency.frameStart_;
+                latency.workNext_                = (latency.workNext_ + 1) % WorkHistory;
+                latency.lastDone_                = swapped;
+                latency.havePhase_               = true;
+            }
+        }
+
+        void LatencyStop() noexcept
+        {
+            for (size_t i = 0; i < latency.fenceCount_; ++i) {
+                latency.deleteSync_(latency.fences_[i].fence_);
+            }
+            latency = LatencyState{};
+        }
+    }  // namespace detail
+}  // namespace dear
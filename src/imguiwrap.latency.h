@@ -0,0 +1,86 @@
+#pragma once
+
+// Input-to-photon latency measurement and low-latency frame pacing for imgui_main.
+//
+// With ImGuiWrapConfig::measureLatency_, imgui_main timestamps keyboard, character, mouse
+// button, cursor and scroll events as GLFW delivers them, and for every frame that saw
+// input measures the time from the earliest of those events to glfwSwapBuffers returning
+// and, where the GL context has fences (GL 3.2 / ARB_sync), to the GPU finishing rendering
+// it. The frame becomes visible at the first refresh after that.
+//
+// GLFW doesn't report when the OS received an event, only when it was dispatched. Events
+// that arrive while the loop is blocked in glfwSwapBuffers are dispatched by the next poll,
+// so in the default mode the figures are a lower bound, short by up to that wait.
+//
+// With ImGuiWrapConfig::lowLatency_ (and vsync), imgui_main instead predicts when the next
+// refresh will be and sleeps until just before the latest moment it can start a frame and
+// still make it, dispatching events as they arrive while it waits. The frame then samples
+// input that is as fresh as possible, rather than input that has been queued since the
+// previous swap. It also waits for the GPU to finish rendering before each swap, so frames
+// can't queue up in the driver, and GPU times are exact rather than observed a frame late.
+//
+//   auto stats = dear::GetInputLatency();
+//   ImGui::Text("input->gpu p50 %.1fms p99 %.1fms", stats.toGpu_.p50Ms_, stats.toGpu_.p99Ms_);
+
+#include <cstddef>
+
+struct GLFWwindow;
+
+namespace dear
+{
+    // LatencyPercentiles summarizes a set of latency samples, in milliseconds.
+    struct LatencyPercentiles
+    {
+        float p50Ms_{0.0F};
+        float p90Ms_{0.0F};
+        float p99Ms_{0.0F};
+        float maxMs_{0.0F};
+    };
+
+    // LatencyStats describes the most recent frames that had input (up to LatencySamples).
+    struct LatencyStats
+    {
+        // samples_ is the number of frames in toSwap_; gpuSamples_ the number in toGpu_,
+        // which is zero when the context has no fences.
+        size_t samples_{0};
+        size_t gpuSamples_{0};
+
+        // toSwap_ measures input to glfwSwapBuffers returning, toGpu_ to GPU completion.
+        LatencyPercentiles toSwap_{};
+        LatencyPercentiles toGpu_{};
+
+        // lowLatency_ is true while frames are being paced; framePeriodMs_ is the refresh
+        // period they are paced to, and frameWorkMs_ the time a frame is expected to take
+        // from polling events to GPU completion.
+        bool  lowLatency_{false};
+        float framePeriodMs_{0.0F};
+        float frameWorkMs_{0.0F};
+    };
+
+    // LatencySamples is how many frames the statistics cover.
+    constexpr size_t LatencySamples = 256;
+
+    // GetInputLatency returns the latency of recent frames. Call from the UI thread.
+    extern LatencyStats GetInputLatency() noexcept;
+
+    // ResetInputLatency discards the samples collected so far.
+    extern void ResetInputLatency() noexcept;
+
+    namespace detail
+    {
+        // LatencyStart installs the GLFW input callbacks; it has to be called before
+        // ImGui_ImplGlfw_InitForOpenGL, which chains to them.
+        extern void LatencyStart(GLFWwindow* window, bool vsync, bool lowLatency,
+                                 float marginMs) noexcept;
+
+        // LatencyPollEvents replaces glfwPollEvents, waiting for the pacing deadline first
+        // in low-latency mode.
+        extern void LatencyPollEvents(GLFWwindow* window) noexcept;
+
+        // LatencySwapBuffers replaces glfwSwapBuffers and takes the frame's measurements.
+        extern void LatencySwapBuffers(GLFWwindow* window) noexcept;
+
+        // LatencyStop releases any outstanding fences while the context is still current.
+        extern void LatencyStop() noexcept;
+    }  // namespace detail
+}  // namespace dear
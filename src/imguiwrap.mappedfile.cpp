@@ -0,0 +1,132 @@
+#include "imguiwrap.mappedfile.h"
+
+#include <utility>
+
+#if defined(_WIN32)
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace dear
+{
+    MappedFile::MappedFile(MappedFile&& rhs) noexcept { *this = std::move(rhs); }
+
+    MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            Close();
+            std::swap(data_, rhs.data_);
+            std::swap(size_, rhs.size_);
+            std::swap(open_, rhs.open_);
+#if defined(_WIN32)
+            std::swap(mapping_, rhs.mapping_);
+#endif
+        }
+        return *this;
+    }
+
+#if defined(_WIN32)
+
+    bool MappedFile::Open(const char* path) noexcept
+    {
+        Close();
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                  nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size{};
+        if (GetFileSizeEx(file, &size) == 0) {
+            CloseHandle(file);
+            return false;
+        }
+        if (size.QuadPart == 0) {
+            CloseHandle(file);
+            open_ = true;
+            return true;
+        }
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        // The mapping keeps the file open.
+        CloseHandle(file);
+        if (mapping == nullptr) {
+            return false;
+        }
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr) {
+            CloseHandle(mapping);
+            return false;
+        }
+        mapping_ = mapping;
+        data_    = static_cast<const uint8_t*>(view);
+        size_    = static_cast<size_t>(size.QuadPart);
+        open_    = true;
+        return true;
+    }
+
+    void MappedFile::Close() noexcept
+    {
+        if (data_ != nullptr) {
+            UnmapViewOfFile(data_);
+        }
+        if (mapping_ != nullptr) {
+            CloseHandle(static_cast<HANDLE>(mapping_));
+        }
+        mapping_ = nullptr;
+        data_    = nullptr;
+        size_    = 0;
+        open_    = false;
+    }
+
+#else
+
+    bool MappedFile::Open(const char* path) noexcept
+    {
+        Close();
+        const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info
+        {};
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            return false;
+        }
+        if (info.st_size == 0) {
+            ::close(fd);
+            open_ = true;
+            return true;
+        }
+        const auto size = static_cast<size_t>(info.st_size);
+        void*      view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        // The mapping keeps the file referenced.
+        ::close(fd);
+        if (view == MAP_FAILED) {
+            return false;
+        }
+        data_ = static_cast<const uint8_t*>(view);
+        size_ = size;
+        open_ = true;
+        return true;
+    }
+
+    void MappedFile::Close() noexcept
+    {
+        if (data_ != nullptr) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast) munmap isn't const.
+            ::munmap(const_cast<uint8_t*>(data_), size_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+        open_ = false;
+    }
+
+#endif
+}  // namespace dear
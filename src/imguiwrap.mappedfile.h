@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dear
+{
+    // MappedFile is a read-only memory mapping of a file, so that large files (or files on
+    // slow network mounts) can be read without copying them through a buffer first.
+    //
+    //   dear::MappedFile file("imgui.ini");
+    //   if (file.IsOpen())
+    //       parse(file.Data(), file.Size());
+    //
+    // An empty file opens successfully, with a null Data() and zero Size().
+    class MappedFile
+    {
+    public:
+        MappedFile() noexcept = default;
+        explicit MappedFile(const char* path) noexcept { (void) Open(path); }
+        ~MappedFile() { Close(); }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& rhs) noexcept;
+        MappedFile& operator=(MappedFile&& rhs) noexcept;
+
+        // Open maps 'path', closing any previous mapping, and returns false if the file
+        // could not be opened or mapped.
+        bool Open(const char* path) noexcept;
+        void Close() noexcept;
+
+        bool           IsOpen() const noexcept { return open_; }
+        const uint8_t* Data() const noexcept { return data_; }
+        size_t         Size() const noexcept { return size_; }
+
+    private:
+        const uint8_t* data_{nullptr};
+        size_t         size_{0};
+        bool           open_{false};
+#if defined(_WIN32)
+        void* mapping_{nullptr};  // HANDLE
+#endif
+    };
+}  // namespace dear
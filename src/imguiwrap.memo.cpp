@@ -0,0 +1,70 @@
+#include "imguiwrap.memo.h"
+
+#include <unordered_map>
+
+namespace
+{
+    // Only ever touched from the UI thread.
+    struct MemoStore
+    {
+        // unordered_map nodes are stable, so slot references survive later insertions.
+        std::unordered_map<ImGuiID, dear::detail::MemoSlot> slots_;
+        int                                                 lastSweep_{0};
+    };
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    MemoStore memoStore;
+
+    void
+    destroySlot(dear::detail::MemoSlot& slot) noexcept
+    {
+        if (slot.value_ != nullptr) {
+            slot.destroy_(slot.value_);
+        }
+        slot = {};
+    }
+
+}  // namespace
+
+namespace dear
+{
+    namespace detail
+    {
+        MemoSlot& MemoFind(ImGuiID id) noexcept
+        {
+            MemoSlot& slot  = memoStore.slots_[id];
+            slot.lastFrame_ = ImGui::GetFrameCount();
+            return slot;
+        }
+
+        void MemoFrameEnd(int evictAfterFrames) noexcept
+        {
+            if (evictAfterFrames <= 0 || memoStore.slots_.empty()) {
+                return;
+            }
+            // Sweep a couple of times per eviction period, rather than every frame.
+            const int frame = ImGui::GetFrameCount();
+            if (frame - memoStore.lastSweep_ < evictAfterFrames / 2) {
+                return;
+            }
+            memoStore.lastSweep_ = frame;
+            for (auto it = memoStore.slots_.begin(); it != memoStore.slots_.end();) {
+                if (frame - it->second.lastFrame_ > evictAfterFrames) {
+                    destroySlot(it->second);
+                    it = memoStore.slots_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        void MemoClear() noexcept
+        {
+            for (auto& [id, slot] : memoStore.slots_) {
+                destroySlot(slot);
+            }
+            memoStore.slots_.clear();
+            memoStore.lastSweep_ = 0;
+        }
+    }  // namespace detail
+}  // namespace dear
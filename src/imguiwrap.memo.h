@@ -0,0 +1,112 @@
+#pragma once
+
+#include "imgui.h"
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace dear
+{
+    namespace detail
+    {
+        // MemoSlot is the type-erased storage behind dear::Memo (and other per-ID caches),
+        // kept across frames in a map keyed by ImGuiID.
+        struct MemoSlot
+        {
+            void* value_{nullptr};
+            void (*destroy_)(void*){nullptr};
+            const void* type_{nullptr};  // see MemoType
+            uint64_t    version_{0};
+            int         lastFrame_{0};
+            bool        valid_{false};  // value_ has been computed for version_
+        };
+
+        // MemoType gives each stored type a unique tag, without RTTI.
+        template<typename T>
+        const void* MemoType() noexcept
+        {
+            static const char tag{};
+            return &tag;
+        }
+
+        // MemoFind returns the slot for an ID, creating an empty one if needed, and marks it
+        // as used this frame. The reference remains valid until the slot is evicted.
+        extern MemoSlot& MemoFind(ImGuiID id) noexcept;
+
+        // MemoHold makes sure the slot holds a T, replacing any value of another type.
+        template<typename T>
+        T& MemoHold(MemoSlot& slot) noexcept
+        {
+            if (slot.type_ != MemoType<T>()) {
+                IM_ASSERT((slot.type_ == nullptr) && "ID reused for a different type of value");
+                if (slot.value_ != nullptr) {
+                    slot.destroy_(slot.value_);
+                }
+                slot.value_   = new T();
+                slot.destroy_ = [](void* value) { delete static_cast<T*>(value); };
+                slot.type_    = MemoType<T>();
+                slot.valid_   = false;
+            }
+            return *static_cast<T*>(slot.value_);
+        }
+
+        // MemoFrameEnd evicts slots that haven't been used for evictAfterFrames frames.
+        extern void MemoFrameEnd(int evictAfterFrames) noexcept;
+
+        // MemoClear destroys all slots.
+        extern void MemoClear() noexcept;
+    }  // namespace detail
+
+    // Memo caches a value derived from your data across frames, recomputing it only when
+    // the version you supply changes:
+    //
+    //   const std::string& summary = dear::Memo<std::string>("summary", log.Version()) &&
+    //                                [&](std::string& text) { text = Summarize(log); };
+    //
+    // The callable is only invoked when the cached value is stale, and may either fill in
+    // the value it is passed, or take no arguments and return the new value. Either way,
+    // '&&' yields a reference to the cached value, which stays valid for the frame.
+    //
+    // Values are keyed by ImGuiID, so a label is resolved against the current ID stack
+    // (the same label in different windows gives different values). Values that are not
+    // used for ImGuiWrapConfig::memoEvictFrames_ frames are destroyed.
+    template<typename T>
+    class Memo
+    {
+    public:
+        Memo(const char* label, uint64_t version) noexcept : Memo(ImGui::GetID(label), version)
+        {}
+        Memo(ImGuiID id, uint64_t version) noexcept
+            : slot_(detail::MemoFind(id))
+            , value_(detail::MemoHold<T>(slot_))
+            , version_(version)
+        {}
+
+        // Stale is true if the value needs to be recomputed.
+        bool Stale() const noexcept { return !slot_.valid_ || slot_.version_ != version_; }
+
+        // Value returns the cached value, whether or not it is stale.
+        T& Value() const noexcept { return value_; }
+
+        template<typename ComputeFn>
+        T& operator&&(ComputeFn&& compute) noexcept
+        {
+            if (Stale()) {
+                if constexpr (std::is_invocable_v<ComputeFn, T&>) {
+                    std::forward<ComputeFn>(compute)(value_);
+                } else {
+                    value_ = std::forward<ComputeFn>(compute)();
+                }
+                slot_.version_ = version_;
+                slot_.valid_   = true;
+            }
+            return value_;
+        }
+
+    private:
+        detail::MemoSlot& slot_;
+        T&                value_;
+        const uint64_t    version_;
+    };
+}  // namespace dear
@@ -0,0 +1,376 @@
+#include "imguiwrap.memory.h"
+#include "imguiwrap.alloc.h"
+#include "imguiwrap.dear.h"
+
+#include "imgui_internal.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    // How often MemoryFrameEnd looks for idle state, in seconds.
+    constexpr double SweepInterval = 1.0;
+
+    // Only ever touched from the UI thread.
+    struct MemoryState
+    {
+        float                compactAfter_{-1.0F};
+        float                releaseIdle_{0.0F};
+        double               lastSweep_{0.0};
+        double               textLastActive_{0.0};
+        std::vector<ImGuiID> releasing_;
+        dear::MemoryReport   report_;  // for ShowMemoryWindow
+    };
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    MemoryState memoryState;
+
+    template<typename T>
+    size_t
+    bytesOf(const ImVector<T>& vector) noexcept
+    {
+        return static_cast<size_t>(vector.Capacity) * sizeof(T);
+    }
+
+    size_t
+    bytesOf(const ImDrawListSplitter& splitter) noexcept
+    {
+        size_t bytes = bytesOf(splitter._Channels);
+        for (const ImDrawChannel& channel : splitter._Channels) {
+            bytes += bytesOf(channel._CmdBuffer) + bytesOf(channel._IdxBuffer);
+        }
+        return bytes;
+    }
+
+    size_t
+    bytesOf(const ImDrawList& list) noexcept
+    {
+        return bytesOf(list.CmdBuffer) + bytesOf(list.IdxBuffer) + bytesOf(list.VtxBuffer) +
+               bytesOf(list._ClipRectStack) + bytesOf(list._TextureIdStack) +
+               bytesOf(list._Path) + bytesOf(list._Splitter);
+    }
+
+    size_t
+    bytesOf(const ImGuiStorage& storage) noexcept
+    {
+        return bytesOf(storage.Data);
+    }
+
+    size_t
+    windowStateBytes(const ImGuiWindow& window) noexcept
+    {
+        size_t bytes = sizeof(ImGuiWindow) + strlen(window.Name) + 1 + bytesOf(window.IDStack) +
+                       bytesOf(window.DC.ChildWindows) + bytesOf(window.DC.ItemWidthStack) +
+                       bytesOf(window.DC.TextWrapPosStack) + bytesOf(window.ColumnsStorage);
+        for (const ImGuiOldColumns& columns : window.ColumnsStorage) {
+            bytes += bytesOf(columns.Columns) + bytesOf(columns.Splitter);
+        }
+        return bytes;
+    }
+
+    // tableBytes counts the table and its column arrays (allocated together, as RawData).
+    // Draw splitters and sort specs are in the temporary data shared by nested tables.
+    size_t
+    tableBytes(const ImGuiTable& table) noexcept
+    {
+        const auto columns = static_cast<size_t>(table.ColumnsCount);
+        return sizeof(ImGuiTable) +
+               columns * (sizeof(ImGuiTableColumn) + sizeof(ImGuiTableColumnIdx) +
+                          sizeof(ImGuiTableCellData)) +
+               bytesOf(table.ColumnsNames.Buf);
+    }
+
+    size_t
+    fontAtlasBytes(const ImFontAtlas& atlas) noexcept
+    {
+        const size_t pixels =
+            static_cast<size_t>(atlas.TexWidth) * static_cast<size_t>(atlas.TexHeight);
+        size_t bytes = sizeof(ImFontAtlas) + bytesOf(atlas.Fonts) + bytesOf(atlas.CustomRects) +
+                       bytesOf(atlas.ConfigData);
+        bytes += atlas.TexPixelsAlpha8 != nullptr ? pixels : 0;
+        bytes += atlas.TexPixelsRGBA32 != nullptr ? pixels * 4 : 0;
+        for (const ImFont* font : atlas.Fonts) {
+            bytes += sizeof(ImFont) + bytesOf(font->Glyphs) + bytesOf(font->IndexAdvanceX) +
+                     bytesOf(font->IndexLookup);
+        }
+        for (const ImFontConfig& config : atlas.ConfigData) {
+            if (config.FontDataOwnedByAtlas) {
+                bytes += static_cast<size_t>(config.FontDataSize);
+            }
+        }
+        return bytes;
+    }
+
+    // forEachTable calls fn with each table in the context's pool.
+    template<typename Fn>
+    void
+    forEachTable(ImGuiContext& g, Fn&& fn) noexcept
+    {
+        // Removed tables stay in the pool's buffer; the map only indexes live ones.
+        for (const ImGuiStorage::ImGuiStoragePair& pair : g.Tables.Map.Data) {
+            if (pair.val_i >= 0) {
+                fn(*g.Tables.GetByIndex(pair.val_i));
+            }
+        }
+    }
+
+    // releaseIdleState frees what ImGui keeps for windows and tables that haven't been
+    // used for the release period.
+    void
+    releaseIdleState(ImGuiContext& g) noexcept
+    {
+        MemoryState& state = memoryState;
+        const auto   idle  = static_cast<double>(state.releaseIdle_);
+        for (ImGuiWindow* window : g.Windows) {
+            if (!window->Active && !window->WasActive && window->StateStorage.Data.Capacity > 0 &&
+                g.Time - static_cast<double>(window->LastTimeActive) > idle) {
+                window->StateStorage.Clear();
+            }
+        }
+
+        state.releasing_.clear();
+        // BeginTable notes the time each table was last used, by its index in the pool.
+        forEachTable(g, [&](const ImGuiTable& table) {
+            const int index = g.Tables.GetIndex(&table);
+            if (index < g.TablesLastTimeActive.Size &&
+                g.Time - static_cast<double>(g.TablesLastTimeActive[index]) > idle) {
+                state.releasing_.push_back(table.ID);
+            }
+        });
+        for (const ImGuiID id : state.releasing_) {
+            ImGui::TableRemove(g.Tables.GetByKey(id));
+        }
+    }
+
+    const char*
+    formatBytes(size_t bytes, char (&buffer)[32]) noexcept
+    {
+        const auto value = static_cast<double>(bytes);
+        if (bytes >= size_t{1} << 20U) {
+            (void) snprintf(buffer, sizeof(buffer), "%.1f MB", value / (1024.0 * 1024.0));
+        } else if (bytes >= size_t{1} << 10U) {
+            (void) snprintf(buffer, sizeof(buffer), "%.1f KB", value / 1024.0);
+        } else {
+            (void) snprintf(buffer, sizeof(buffer), "%zu B", bytes);
+        }
+        return buffer;
+    }
+
+    void
+    bytesCell(size_t bytes) noexcept
+    {
+        char buffer[32];
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(formatBytes(bytes, buffer));
+    }
+
+}  // namespace
+
+namespace dear
+{
+    void GetMemoryReport(MemoryReport& report) noexcept
+    {
+        std::vector<WindowMemory> windows = std::move(report.perWindow_);
+        std::vector<TableMemory>  tables  = std::move(report.perTable_);
+        windows.clear();
+        tables.clear();
+        report = MemoryReport{};
+
+        ImGuiContext* context = ImGui::GetCurrentContext();
+        if (context != nullptr) {
+            ImGuiContext& g = *context;
+            for (const ImGuiWindow* window : g.Windows) {
+                WindowMemory memory{};
+                memory.name_        = window->Name;
+                memory.drawList_    = bytesOf(*window->DrawList);
+                memory.storage_     = bytesOf(window->StateStorage);
+                memory.state_       = windowStateBytes(*window);
+                memory.idleSeconds_ = static_cast<float>(
+                    std::max(g.Time - static_cast<double>(window->LastTimeActive), 0.0));
+                memory.compacted_ = window->MemoryCompacted;
+                report.windows_ += memory.state_;
+                report.drawLists_ += memory.drawList_;
+                report.storage_ += memory.storage_;
+                windows.push_back(memory);
+            }
+
+            forEachTable(g, [&](const ImGuiTable& table) {
+                TableMemory memory{};
+                memory.id_         = table.ID;
+                memory.window_     = table.OuterWindow != nullptr ? table.OuterWindow->Name : "";
+                memory.columns_    = table.ColumnsCount;
+                memory.bytes_      = tableBytes(table);
+                memory.idleFrames_ = std::max(g.FrameCount - table.LastFrameActive, 0);
+                memory.compacted_  = table.MemoryCompacted;
+                report.tables_ += memory.bytes_;
+                tables.push_back(memory);
+            });
+
+            for (const ImGuiViewportP* viewport : g.Viewports) {
+                for (const ImDrawList* list : viewport->DrawLists) {
+                    report.drawLists_ += list != nullptr ? bytesOf(*list) : 0;
+                }
+            }
+            report.fontAtlas_ = g.IO.Fonts != nullptr ? fontAtlasBytes(*g.IO.Fonts) : 0;
+
+            const ImGuiInputTextState& text = g.InputTextState;
+            report.other_ = sizeof(ImGuiContext) + bytesOf(g.Windows) +
+                            bytesOf(g.WindowsFocusOrder) + bytesOf(g.WindowsTempSortBuffer) +
+                            bytesOf(g.WindowsById) + bytesOf(g.Tables.Buf) +
+                            bytesOf(g.Tables.Map) + bytesOf(g.TablesLastTimeActive) +
+                            bytesOf(g.TablesTempDataStack) +
+                            bytesOf(g.SettingsWindows.Buf) + bytesOf(g.SettingsTables.Buf) +
+                            bytesOf(g.SettingsIniData.Buf) + bytesOf(text.TextW) +
+                            bytesOf(text.TextA) + bytesOf(text.InitialTextA) +
+                            bytesOf(g.ClipboardHandlerData);
+            for (const ImGuiTableTempData& temp : g.TablesTempDataStack) {
+                report.other_ += bytesOf(temp.DrawSplitter) + bytesOf(temp.SortSpecsMulti);
+            }
+            // The pool's buffer holds the tables themselves, counted above.
+            report.other_ -= std::min(report.other_, sizeof(ImGuiTable) * tables.size());
+        }
+
+        const AllocatorStats allocator = GetAllocatorStats();
+        report.allocatedBytes_         = allocator.pooled_ ? allocator.liveBytes_ : 0;
+
+        std::sort(windows.begin(), windows.end(),
+                  [](const WindowMemory& lhs, const WindowMemory& rhs) {
+                      return lhs.Total() > rhs.Total();
+                  });
+        std::sort(tables.begin(), tables.end(),
+                  [](const TableMemory& lhs, const TableMemory& rhs) {
+                      return lhs.bytes_ > rhs.bytes_;
+                  });
+        report.perWindow_ = std::move(windows);
+        report.perTable_  = std::move(tables);
+    }
+
+    void ShowMemoryWindow(bool* open) noexcept
+    {
+        ImGui::SetNextWindowSize(ImVec2(640.0F, 480.0F), ImGuiCond_FirstUseEver);
+        Begin("Memory", open) && [] {
+            MemoryReport& report = memoryState.report_;
+            GetMemoryReport(report);
+
+            constexpr ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders |
+                                              ImGuiTableFlags_Resizable;
+            Table("totals", 2, flags) && [&] {
+                const auto row = [](const char* label, size_t bytes) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(label);
+                    bytesCell(bytes);
+                };
+                row("Windows", report.windows_);
+                row("Draw lists", report.drawLists_);
+                row("Storage", report.storage_);
+                row("Tables", report.tables_);
+                row("Font atlas", report.fontAtlas_);
+                row("Other", report.other_);
+                row("Total", report.Total());
+                if (report.allocatedBytes_ > 0) {
+                    row("Allocated (pool allocator)", report.allocatedBytes_);
+                }
+            };
+
+            constexpr ImGuiTableFlags listFlags = flags | ImGuiTableFlags_ScrollY;
+            const ImVec2              listSize(0.0F, ImGui::GetTextLineHeightWithSpacing() * 12.0F);
+            CollapsingHeader("Windows", ImGuiTreeNodeFlags_DefaultOpen) && [&] {
+                Table("windows", 5, listFlags, listSize) && [&] {
+                    ImGui::TableSetupScrollFreeze(0, 1);
+                    ImGui::TableSetupColumn("Window", ImGuiTableColumnFlags_WidthStretch);
+                    ImGui::TableSetupColumn("Draw list");
+                    ImGui::TableSetupColumn("Storage");
+                    ImGui::TableSetupColumn("State");
+                    ImGui::TableSetupColumn("Idle");
+                    ImGui::TableHeadersRow();
+                    ImGuiListClipper clipper;
+                    clipper.Begin(static_cast<int>(report.perWindow_.size()));
+                    while (clipper.Step()) {
+                        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                            const WindowMemory& window =
+                                report.perWindow_[static_cast<size_t>(row)];
+                            ImGui::TableNextRow();
+                            ImGui::TableNextColumn();
+                            ImGui::TextUnformatted(window.name_);
+                            bytesCell(window.drawList_);
+                            bytesCell(window.storage_);
+                            bytesCell(window.state_);
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%.0fs%s", static_cast<double>(window.idleSeconds_),
+                                        window.compacted_ ? " (compacted)" : "");
+                        }
+                    }
+                };
+            };
+            CollapsingHeader("Tables") && [&] {
+                Table("tables", 5, listFlags, listSize) && [&] {
+                    ImGui::TableSetupScrollFreeze(0, 1);
+                    ImGui::TableSetupColumn("ID");
+                    ImGui::TableSetupColumn("Window", ImGuiTableColumnFlags_WidthStretch);
+                    ImGui::TableSetupColumn("Columns");
+                    ImGui::TableSetupColumn("Size");
+                    ImGui::TableSetupColumn("Idle");
+                    ImGui::TableHeadersRow();
+                    ImGuiListClipper clipper;
+                    clipper.Begin(static_cast<int>(report.perTable_.size()));
+                    while (clipper.Step()) {
+                        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                            const TableMemory& table = report.perTable_[static_cast<size_t>(row)];
+                            ImGui::TableNextRow();
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%08X", table.id_);
+                            ImGui::TableNextColumn();
+                            ImGui::TextUnformatted(table.window_);
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%d", table.columns_);
+                            bytesCell(table.bytes_);
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%d frames%s", table.idleFrames_,
+                                        table.compacted_ ? " (compacted)" : "");
+                        }
+                    }
+                };
+            };
+        };
+    }
+
+    namespace detail
+    {
+        void MemoryStart(float compactAfterSeconds, float releaseIdleSeconds) noexcept
+        {
+            memoryState               = MemoryState{};
+            memoryState.compactAfter_ = compactAfterSeconds;
+            memoryState.releaseIdle_  = releaseIdleSeconds;
+            ImGui::GetIO().ConfigMemoryCompactTimer = compactAfterSeconds;
+        }
+
+        void MemoryFrameEnd() noexcept
+        {
+            ImGuiContext&        g     = *ImGui::GetCurrentContext();
+            MemoryState&         state = memoryState;
+            ImGuiInputTextState& text  = g.InputTextState;
+            if (text.ID != 0 && g.ActiveId == text.ID) {
+                state.textLastActive_ = g.Time;
+            }
+            if (g.Time - state.lastSweep_ < SweepInterval) {
+                return;
+            }
+            state.lastSweep_ = g.Time;
+
+            // InputText only looks at the state while its ID is the active one.
+            if (state.compactAfter_ >= 0.0F && text.ID != 0 && g.ActiveId != text.ID &&
+                g.Time - state.textLastActive_ > static_cast<double>(state.compactAfter_)) {
+                text.ClearFreeMemory();
+                text.ID = 0;
+            }
+            if (state.releaseIdle_ > 0.0F) {
+                releaseIdleState(g);
+            }
+        }
+
+        void MemoryStop() noexcept { memoryState = MemoryState{}; }
+    }  // namespace detail
+}  // namespace dear
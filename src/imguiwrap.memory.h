@@ -0,0 +1,109 @@
+#pragma once
+
+// Context memory report and idle-state compaction for imgui_main.
+//
+// ImGui keeps state for every window and table it has seen for the lifetime of its context.
+// Once a window or table has gone unused for io.ConfigMemoryCompactTimer seconds
+// (ImGuiWrapConfig::compactAfterSeconds_) ImGui frees some of it itself: draw list
+// buffers, ID stacks, table sort specs and column names. The rest it never frees, so tools
+// that open windows and tables with generated IDs, or trees over changing data, grow for as
+// long as they run. With ImGuiWrapConfig::releaseIdleSeconds_, imgui_main also releases,
+// for windows and tables not submitted for that long:
+//
+//  - the window's ImGuiStorage: tree node and collapsing header open state, and anything
+//    your code keeps via ImGui::GetStateStorage();
+//  - the table itself (column widths, order and sorting), which is recreated from its
+//    saved settings if it is submitted again.
+//
+// It also frees the buffers and undo history of the last text field edited once that has
+// been inactive for compactAfterSeconds_.
+//
+// dear::GetMemoryReport breaks down what the context holds by window, table, draw list and
+// font atlas, and dear::ShowMemoryWindow displays it. Sizes are worked out from the
+// capacities of ImGui's buffers, so they don't include allocator overhead; when
+// ImGuiWrapConfig::poolAllocator_ is on, the allocator's count of live bytes is reported
+// alongside for comparison.
+
+#include "imgui.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace dear
+{
+    // WindowMemory is what the context holds for one window.
+    struct WindowMemory
+    {
+        const char* name_{nullptr};  // owned by the window
+
+        // drawList_ is the window's draw list buffers, storage_ its ImGuiStorage, and
+        // state_ the window itself and its other buffers.
+        size_t drawList_{0};
+        size_t storage_{0};
+        size_t state_{0};
+
+        // idleSeconds_ is the time since the window was last submitted, and compacted_ is
+        // true if ImGui has freed its transient buffers since.
+        float idleSeconds_{0.0F};
+        bool  compacted_{false};
+
+        size_t Total() const noexcept { return drawList_ + storage_ + state_; }
+    };
+
+    // TableMemory is what the context holds for one table.
+    struct TableMemory
+    {
+        ImGuiID     id_{0};
+        const char* window_{nullptr};  // the window the table was last submitted in
+        int         columns_{0};
+        size_t      bytes_{0};
+        int         idleFrames_{0};
+        bool        compacted_{false};
+    };
+
+    // MemoryReport is a snapshot of the memory held by the current ImGui context.
+    struct MemoryReport
+    {
+        // windows_ is window state other than draw lists and storage; drawLists_ includes
+        // the background and foreground draw lists; fontAtlas_ is the glyphs and the CPU
+        // copy of the atlas texture; other_ is settings, text editing and bookkeeping.
+        size_t windows_{0};
+        size_t drawLists_{0};
+        size_t storage_{0};
+        size_t tables_{0};
+        size_t fontAtlas_{0};
+        size_t other_{0};
+
+        // allocatedBytes_ is the pool allocator's count of bytes ImGui has allocated, or
+        // zero if it isn't installed (including when only the allocation checker's counting
+        // allocator is).
+        size_t allocatedBytes_{0};
+
+        std::vector<WindowMemory> perWindow_;
+        std::vector<TableMemory>  perTable_;
+
+        size_t Total() const noexcept
+        {
+            return windows_ + drawLists_ + storage_ + tables_ + fontAtlas_ + other_;
+        }
+    };
+
+    // GetMemoryReport fills report for the current context, reusing its vectors.
+    extern void GetMemoryReport(MemoryReport& report) noexcept;
+
+    // ShowMemoryWindow draws a window with the totals and the largest windows and tables.
+    extern void ShowMemoryWindow(bool* open = nullptr) noexcept;
+
+    namespace detail
+    {
+        // MemoryStart applies the compaction policy to the new context.
+        extern void MemoryStart(float compactAfterSeconds, float releaseIdleSeconds) noexcept;
+
+        // MemoryFrameEnd releases idle state, checking about once a second; imgui_main
+        // calls it after ImGui::Render.
+        extern void MemoryFrameEnd() noexcept;
+
+        // MemoryStop forgets the policy's bookkeeping, before the context is destroyed.
+        extern void MemoryStop() noexcept;
+    }  // namespace detail
+}  // namespace dear
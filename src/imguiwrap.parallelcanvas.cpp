@@ -0,0 +1,399 @@
+#include "imguiwrap.parallelcanvas.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr unsigned MaxWorkers = 63;
+
+    // More chunks than threads, so that uneven chunks still balance out.
+    constexpr size_t ChunksPerThread = 4;
+
+    // Chunk draw lists are reserved this much more room than they used last time, as a
+    // fraction of it, so that they don't have to grow on the workers.
+    constexpr int HeadroomDivisor = 2;
+
+    // Where one source list's data goes in the destination list.
+    struct Placement
+    {
+        int vtxBase_{0};
+        int idxBase_{0};
+        int cmdBase_{0};
+    };
+
+    bool
+    skippable(const ImDrawCmd& cmd) noexcept
+    {
+        return cmd.ElemCount == 0 && cmd.UserCallback == nullptr;
+    }
+
+    // ImDrawIdx is normally 16 bits, in which case each spliced command gets its own
+    // VtxOffset and indices are copied as-is; otherwise indices have to be rebased.
+    bool
+    useVtxOffset(const ImDrawList* dst) noexcept
+    {
+        return sizeof(ImDrawIdx) == 2 && (dst->Flags & ImDrawListFlags_AllowVtxOffset) != 0;
+    }
+
+    int
+    countCommands(const ImDrawList& src) noexcept
+    {
+        return static_cast<int>(
+            std::count_if(src.CmdBuffer.begin(), src.CmdBuffer.end(),
+                          [](const ImDrawCmd& cmd) { return !skippable(cmd); }));
+    }
+
+    // beginSplice drops dst's open command if nothing has been drawn with it yet, and grows
+    // dst's buffers by the given amounts, returning where the new data starts.
+    Placement
+    beginSplice(ImDrawList* dst, int vtxCount, int idxCount, int cmdCount) noexcept
+    {
+        dst->_PopUnusedDrawCmd();
+        const Placement at{dst->VtxBuffer.Size, dst->IdxBuffer.Size, dst->CmdBuffer.Size};
+        dst->VtxBuffer.resize(at.vtxBase_ + vtxCount);
+        dst->IdxBuffer.resize(at.idxBase_ + idxCount);
+        dst->CmdBuffer.resize(at.cmdBase_ + cmdCount);
+        return at;
+    }
+
+    // copyList copies src into the space reserved for it by beginSplice.
+    void
+    copyList(ImDrawList* dst, const ImDrawList& src, const Placement& at) noexcept
+    {
+        if (src.VtxBuffer.Size > 0) {
+            (void) memcpy(dst->VtxBuffer.Data + at.vtxBase_, src.VtxBuffer.Data,
+                          static_cast<size_t>(src.VtxBuffer.Size) * sizeof(ImDrawVert));
+        }
+
+        const bool         vtxOffset  = useVtxOffset(dst);
+        const unsigned int headerBase = dst->_CmdHeader.VtxOffset;
+        ImDrawIdx*         idx        = dst->IdxBuffer.Data + at.idxBase_;
+        if (vtxOffset) {
+            if (src.IdxBuffer.Size > 0) {
+                (void) memcpy(idx, src.IdxBuffer.Data,
+                              static_cast<size_t>(src.IdxBuffer.Size) * sizeof(ImDrawIdx));
+            }
+        } else {
+            const unsigned int rebase = static_cast<unsigned int>(at.vtxBase_) - headerBase;
+            IM_ASSERT((sizeof(ImDrawIdx) > 2 ||
+                       rebase + static_cast<unsigned int>(src.VtxBuffer.Size) <= (1U << 16U)) &&
+                      "Too many vertices for 16-bit indices: enable RendererHasVtxOffset");
+            for (int i = 0; i < src.IdxBuffer.Size; ++i) {
+                idx[i] = static_cast<ImDrawIdx>(src.IdxBuffer.Data[i] + rebase);
+            }
+        }
+
+        ImDrawCmd* out = dst->CmdBuffer.Data + at.cmdBase_;
+        for (const ImDrawCmd& cmd : src.CmdBuffer) {
+            if (skippable(cmd)) {
+                continue;
+            }
+            *out = cmd;
+            out->IdxOffset += static_cast<unsigned int>(at.idxBase_);
+            out->VtxOffset = vtxOffset ? cmd.VtxOffset + static_cast<unsigned int>(at.vtxBase_)
+                                       : headerBase;
+            ++out;
+        }
+    }
+
+    // endSplice opens a new command for whatever dst draws next, as ImDrawList would after
+    // changing its vertex offset.
+    void
+    endSplice(ImDrawList* dst) noexcept
+    {
+        if (useVtxOffset(dst)) {
+            dst->_CmdHeader.VtxOffset = static_cast<unsigned int>(dst->VtxBuffer.Size);
+        }
+        dst->_VtxCurrentIdx =
+            static_cast<unsigned int>(dst->VtxBuffer.Size) - dst->_CmdHeader.VtxOffset;
+        dst->_VtxWritePtr = dst->VtxBuffer.Data + dst->VtxBuffer.Size;
+        dst->_IdxWritePtr = dst->IdxBuffer.Data + dst->IdxBuffer.Size;
+        dst->AddDrawCmd();
+    }
+
+    // CanvasPool runs batches of tasks on worker threads, with the calling thread joining
+    // in. Task counts are small (a few per thread), so claims simply take the mutex.
+    class CanvasPool
+    {
+    public:
+        using TaskFn = void (*)(void* context, size_t task);
+
+        ~CanvasPool() { Shutdown(); }
+
+        // Threads returns the number of threads, including the caller, that Run uses.
+        size_t Threads() noexcept
+        {
+            if (!started_) {
+                start();
+            }
+            return workers_.size() + 1;
+        }
+
+        void Run(size_t tasks, TaskFn fn, void* context) noexcept
+        {
+            uint64_t generation{0};
+            {
+                const std::lock_guard<std::mutex> lock(mutex_);
+                fn_        = fn;
+                context_   = context;
+                tasks_     = tasks;
+                nextTask_  = 0;
+                remaining_ = tasks;
+                generation = ++generation_;
+            }
+            wake_.notify_all();
+
+            runTasks(generation);
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [this] { return remaining_ == 0; });
+        }
+
+        void Shutdown() noexcept
+        {
+            {
+                const std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            wake_.notify_all();
+            for (auto& worker : workers_) {
+                worker.join();
+            }
+            workers_.clear();
+            lists_.clear();
+            stop_    = false;
+            started_ = false;
+        }
+
+        // Per-chunk draw lists, kept between frames so their buffers stop growing.
+        std::vector<std::unique_ptr<ImDrawList>> lists_;
+        std::vector<Placement>                   placements_;
+
+    private:
+        void start() noexcept
+        {
+            started_             = true;
+            const unsigned cores = std::thread::hardware_concurrency();
+            const unsigned count = std::min(cores > 1 ? cores - 1 : 0, MaxWorkers);
+            workers_.reserve(count);
+            for (unsigned i = 0; i < count; ++i) {
+                workers_.emplace_back([this] { workerMain(); });
+            }
+        }
+
+        void workerMain() noexcept
+        {
+            uint64_t seen{0};
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                    if (stop_) {
+                        return;
+                    }
+                    seen = generation_;
+                }
+                runTasks(seen);
+            }
+        }
+
+        // runTasks claims and runs tasks from the given batch until there are none left;
+        // a worker that wakes late must not claim tasks from the batch after.
+        void runTasks(uint64_t generation) noexcept
+        {
+            for (;;) {
+                TaskFn fn{nullptr};
+                void*  context{nullptr};
+                size_t task{0};
+                {
+                    const std::lock_guard<std::mutex> lock(mutex_);
+                    if (generation_ != generation || nextTask_ >= tasks_) {
+                        return;
+                    }
+                    task    = nextTask_++;
+                    fn      = fn_;
+                    context = context_;
+                }
+                fn(context, task);
+                bool last{false};
+                {
+                    const std::lock_guard<std::mutex> lock(mutex_);
+                    last = --remaining_ == 0;
+                }
+                if (last) {
+                    done_.notify_one();
+                }
+            }
+        }
+
+        std::mutex               mutex_;
+        std::condition_variable  wake_;
+        std::condition_variable  done_;
+        std::vector<std::thread> workers_;
+        TaskFn                   fn_{nullptr};
+        void*                    context_{nullptr};
+        size_t                   tasks_{0};
+        size_t                   nextTask_{0};
+        size_t                   remaining_{0};
+        uint64_t                 generation_{0};
+        bool                     stop_{false};
+        bool                     started_{false};
+    };
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    CanvasPool canvasPool;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    bool canvasRunning{false};
+
+    // What the tasks of one CanvasRun need to know.
+    struct CanvasJob
+    {
+        ImDrawList*                 dst_;
+        size_t                      count_;
+        size_t                      chunks_;
+        dear::detail::CanvasChunkFn fn_;
+        void*                       context_;
+        ImVec2                      clipMin_;
+        ImVec2                      clipMax_;
+        ImTextureID                 texture_;
+    };
+
+    // reserveChunk resets a chunk's draw list for reuse, on the calling thread, making sure
+    // its buffers have room for as much again as it held last time plus the headroom.
+    //
+    // Workers mustn't allocate through ImGui if it can be helped: besides needing a
+    // thread-safe allocator, ImGui::MemAlloc counts allocations in the context without
+    // synchronization.
+    void
+    reserveChunk(ImDrawList& list) noexcept
+    {
+        const int vtxCount = list.VtxBuffer.Size;
+        const int idxCount = list.IdxBuffer.Size;
+        const int cmdCount = list.CmdBuffer.Size;
+        list._ResetForNewFrame();
+        list.VtxBuffer.reserve(vtxCount + vtxCount / HeadroomDivisor);
+        list.IdxBuffer.reserve(idxCount + idxCount / HeadroomDivisor);
+        list.CmdBuffer.reserve(cmdCount + cmdCount / HeadroomDivisor + 1);
+        list._ClipRectStack.reserve(8);
+        list._TextureIdStack.reserve(8);
+    }
+
+    void
+    drawChunk(void* context, size_t chunk) noexcept
+    {
+        const auto& job  = *static_cast<const CanvasJob*>(context);
+        ImDrawList& list = *canvasPool.lists_[chunk];
+        list.Flags        = job.dst_->Flags;
+        list._FringeScale = job.dst_->_FringeScale;
+        list.PushTextureID(job.texture_);
+        list.PushClipRect(job.clipMin_, job.clipMax_);
+
+        const size_t begin = job.count_ * chunk / job.chunks_;
+        const size_t end   = job.count_ * (chunk + 1) / job.chunks_;
+        job.fn_(job.context_, list, begin, end);
+    }
+
+    void
+    copyChunk(void* context, size_t chunk) noexcept
+    {
+        const auto& job = *static_cast<const CanvasJob*>(context);
+        copyList(job.dst_, *canvasPool.lists_[chunk], canvasPool.placements_[chunk]);
+    }
+
+}  // namespace
+
+namespace dear
+{
+    namespace detail
+    {
+        void SpliceDrawCommands(ImDrawList* dst, const ImDrawList& src) noexcept
+        {
+            const int cmdCount = countCommands(src);
+            if (cmdCount == 0) {
+                return;
+            }
+            const Placement at =
+                beginSplice(dst, src.VtxBuffer.Size, src.IdxBuffer.Size, cmdCount);
+            copyList(dst, src, at);
+            endSplice(dst);
+        }
+
+        void CanvasRun(ImDrawList* dst, size_t count, size_t minChunk, CanvasChunkFn fn,
+                       void* context) noexcept
+        {
+            IM_ASSERT(!canvasRunning && "ParallelCanvas can't be nested");
+            const size_t chunks = std::min(count / std::max<size_t>(minChunk, 1),
+                                           canvasPool.Threads() * ChunksPerThread);
+            if (chunks <= 1) {
+                // Not worth splitting: draw straight into the target.
+                if (count > 0) {
+                    fn(context, *dst, 0, count);
+                }
+                return;
+            }
+            canvasRunning = true;
+
+            ImDrawListSharedData* shared = ImGui::GetDrawListSharedData();
+            auto&                 lists  = canvasPool.lists_;
+            // New lists have no idea how big they need to be, so the first time they are
+            // used, the chunks are drawn on this thread and any growth happens here.
+            const bool fresh = lists.size() < chunks;
+            while (lists.size() < chunks) {
+                lists.push_back(std::make_unique<ImDrawList>(shared));
+            }
+            for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                lists[chunk]->_Data = shared;
+                reserveChunk(*lists[chunk]);
+            }
+
+            CanvasJob job{dst,
+                          count,
+                          chunks,
+                          fn,
+                          context,
+                          dst->GetClipRectMin(),
+                          dst->GetClipRectMax(),
+                          dst->_CmdHeader.TextureId};
+            if (fresh) {
+                for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                    drawChunk(&job, chunk);
+                }
+            } else {
+                canvasPool.Run(chunks, drawChunk, &job);
+            }
+
+            // Lay the chunks out one after another, then copy them in parallel too.
+            int vtxCount{0}, idxCount{0}, cmdCount{0};
+            auto& placements = canvasPool.placements_;
+            placements.resize(chunks);
+            for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                placements[chunk] = Placement{vtxCount, idxCount, cmdCount};
+                vtxCount += lists[chunk]->VtxBuffer.Size;
+                idxCount += lists[chunk]->IdxBuffer.Size;
+                cmdCount += countCommands(*lists[chunk]);
+            }
+            if (cmdCount > 0) {
+                const Placement at = beginSplice(dst, vtxCount, idxCount, cmdCount);
+                for (auto& placement : placements) {
+                    placement.vtxBase_ += at.vtxBase_;
+                    placement.idxBase_ += at.idxBase_;
+                    placement.cmdBase_ += at.cmdBase_;
+                }
+                canvasPool.Run(chunks, copyChunk, &job);
+                endSplice(dst);
+            }
+
+            canvasRunning = false;
+        }
+
+        void CanvasShutdown() noexcept { canvasPool.Shutdown(); }
+    }  // namespace detail
+}  // namespace dear
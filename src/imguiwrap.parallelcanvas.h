@@ -0,0 +1,92 @@
+#pragma once
+
+// dear::ParallelCanvas generates custom draw-list geometry on worker threads.
+//
+// Building geometry for large visualizations (scatter plots with millions of points,
+// graphs with millions of edges) through ImDrawList is usually the most expensive part of
+// the frame, and entirely single-threaded. ParallelCanvas splits an index range into
+// chunks, has a pool of worker threads (plus the UI thread) run your callable on each
+// chunk with a draw list of its own, then splices the chunks' commands, vertices and
+// indices into the target draw list in chunk order, as if they'd been drawn there.
+//
+// Each chunk's draw list starts with the target's current clip rect and texture, and any
+// clip rects or textures it pushes are preserved through the splice.
+
+#include "imgui.h"
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace dear
+{
+    namespace detail
+    {
+        // SpliceDrawCommands appends src's commands, vertices and indices to dst, keeping
+        // their clip rects and textures, and then re-opens dst so that subsequent drawing
+        // continues with dst's own clip rect and texture.
+        extern void SpliceDrawCommands(ImDrawList* dst, const ImDrawList& src) noexcept;
+
+        using CanvasChunkFn = void (*)(void* context, ImDrawList& list, size_t begin,
+                                       size_t end);
+
+        // CanvasRun calls fn for chunks of [0, count) in parallel and splices the results
+        // into dst, in order.
+        extern void CanvasRun(ImDrawList* dst, size_t count, size_t minChunk, CanvasChunkFn fn,
+                              void* context) noexcept;
+
+        // CanvasShutdown stops the worker threads and frees their draw lists; imgui_main
+        // calls it before destroying the ImGui context.
+        extern void CanvasShutdown() noexcept;
+    }  // namespace detail
+
+    // ParallelCanvas draws [0, count) in chunks of at least minChunk items, concurrently:
+    //
+    //   dear::ParallelCanvas(points.size()) && [&](ImDrawList& list, size_t begin, size_t end) {
+    //       for (size_t i = begin; i < end; ++i) {
+    //           list.AddCircleFilled(origin + points[i], 2.0F, colors[i]);
+    //       }
+    //   };
+    //
+    // The callable is invoked from several threads at once, so it must only read shared
+    // state, and must not call any other ImGui functions. '&&' returns once everything has
+    // been spliced into the current window's draw list (or the one you pass in).
+    //
+    // Chunk draw lists are kept between frames, and before each run are given room for
+    // half as much again as they last held, so the workers don't allocate; chunks are drawn
+    // on the calling thread the first time. If a chunk's geometry grows by more than that
+    // from one run to the next, its list grows on a worker: ImGui's allocator (see
+    // ImGui::SetAllocatorFunctions) must then be thread-safe, as malloc and
+    // ImGuiWrapConfig::poolAllocator_ are, and ImGui's count of active allocations in
+    // Metrics isn't updated atomically.
+    class ParallelCanvas
+    {
+    public:
+        static constexpr size_t DefaultMinChunk = 4096;
+
+        explicit ParallelCanvas(size_t count, size_t minChunk = DefaultMinChunk) noexcept
+            : ParallelCanvas(ImGui::GetWindowDrawList(), count, minChunk)
+        {}
+        ParallelCanvas(ImDrawList* target, size_t count,
+                       size_t minChunk = DefaultMinChunk) noexcept
+            : target_(target), count_(count), minChunk_(minChunk)
+        {}
+
+        template<typename ChunkFn>
+        void operator&&(ChunkFn&& fn) noexcept
+        {
+            using Fn = std::remove_reference_t<ChunkFn>;
+            detail::CanvasRun(
+                target_, count_, minChunk_,
+                [](void* context, ImDrawList& list, size_t begin, size_t end) {
+                    (*static_cast<Fn*>(context))(list, begin, end);
+                },
+                const_cast<void*>(static_cast<const void*>(&fn)));
+        }
+
+    private:
+        ImDrawList* target_;
+        size_t      count_;
+        size_t      minChunk_;
+    };
+}  // namespace dear
@@ -0,0 +1,534 @@
+// Profiling zones: completed zones are appended to per-thread, single-writer buffers
+// without locking, and written out as Chrome trace-event JSON by a background thread at
+// the end of a capture.
+//
+// Only built when the IMGUIWRAP_PROFILING cmake option is on; see imguiwrap.profile.h.
+
+#include "imguiwrap.profile.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef IMGUIWRAP_PROFILING
+#    error "imguiwrap.profile.cpp requires IMGUIWRAP_PROFILING"
+#endif
+
+namespace
+{
+    // Each thread can record up to EventsPerChunk * MaxChunks zones per capture.
+    constexpr size_t EventsPerChunk = 16384;
+    constexpr size_t MaxChunks      = 1024;
+
+    // Zones nested deeper than this are still balanced, but not recorded.
+    constexpr size_t MaxDepth = 64;
+
+    // Per-thread cache of name pointer -> interned name, so the hot path needn't lock.
+    constexpr unsigned NameCacheBits = 8;
+
+    constexpr uint32_t NoName = ~uint32_t{0};
+
+    struct Event
+    {
+        uint64_t start_;
+        uint64_t end_;
+        uint32_t name_;
+        uint32_t depth_;
+    };
+
+    uint64_t
+    now() noexcept
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+    }
+
+    // NameTable keeps a copy of every zone name seen during a capture: labels are often
+    // formatted into a buffer that is reused for the next row.
+    class NameTable
+    {
+    public:
+        // Intern returns the id of name, and the copy it is stored as, which lives for
+        // the rest of the process.
+        uint32_t Intern(const char* name, const char** copy) noexcept
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            if (auto it = ids_.find(name); it != ids_.end()) {
+                *copy = names_[it->second].get();
+                return it->second;
+            }
+            const size_t length = std::strlen(name);
+            auto         stored = std::make_unique<char[]>(length + 1);
+            std::memcpy(stored.get(), name, length + 1);
+            const auto id = static_cast<uint32_t>(names_.size());
+            *copy         = stored.get();
+            ids_.emplace(std::string_view(stored.get(), length), id);
+            names_.push_back(std::move(stored));
+            return id;
+        }
+
+        // Snapshot lists the names interned so far, by id; the copies never move.
+        void Snapshot(std::vector<const char*>& names) noexcept
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            names.reserve(names_.size());
+            for (const auto& name : names_) {
+                names.push_back(name.get());
+            }
+        }
+
+    private:
+        std::mutex                                  mutex_;
+        std::vector<std::unique_ptr<char[]>>        names_;
+        std::unordered_map<std::string_view, uint32_t> ids_;
+    };
+
+    // ThreadBuffer holds the zones completed by one thread. Only that thread writes to
+    // it; readers may look at events [0, count_) once they've seen count_.
+    struct ThreadBuffer
+    {
+        ~ThreadBuffer()
+        {
+            for (auto& chunk : chunks_) {
+                delete[] chunk.load();
+            }
+        }
+
+        std::array<std::atomic<Event*>, MaxChunks> chunks_{};
+        std::atomic<size_t>                        count_{0};
+        std::atomic<uint64_t>                      dropped_{0};
+        std::atomic<uint64_t>                      capture_{0};  // which capture count_ is for
+        uint32_t                                   tid_{0};
+
+        // inUse_ is cleared when the owning thread exits, so that another can take it over.
+        std::atomic<bool> inUse_{true};
+    };
+
+    struct NameCacheEntry
+    {
+        const char* key_{nullptr};
+        const char* copy_{nullptr};
+        uint32_t    id_{NoName};
+    };
+
+    // ThreadState is the calling thread's zone stack.
+    struct ThreadState
+    {
+        ThreadState() noexcept = default;
+        ThreadState(const ThreadState&) = delete;
+        ThreadState& operator=(const ThreadState&) = delete;
+
+        ~ThreadState()
+        {
+            if (buffer_ != nullptr) {
+                buffer_->inUse_.store(false, std::memory_order_release);
+            }
+        }
+
+        ThreadBuffer*                                     buffer_{nullptr};
+        size_t                                            depth_{0};
+        std::array<uint64_t, MaxDepth>                    starts_{};
+        std::array<uint32_t, MaxDepth>                    names_{};
+        std::array<NameCacheEntry, size_t{1} << NameCacheBits> cache_{};
+    };
+
+    thread_local ThreadState threadState;
+
+    struct Profiler
+    {
+        std::atomic<bool>     recording_{false};
+        std::atomic<uint64_t> capture_{0};
+
+        std::mutex                                 mutex_;  // guards threads_, lastTid_
+        std::vector<std::unique_ptr<ThreadBuffer>> threads_;
+        uint32_t                                   lastTid_{0};
+        NameTable                                  names_;
+
+        // Only touched from the UI thread.
+        int           pendingFrames_{0};
+        int           framesLeft_{0};
+        int           frames_{0};
+        std::string   path_;
+        uint64_t      epoch_{0};
+        ThreadBuffer* uiThread_{nullptr};
+    };
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    Profiler profiler;
+
+    // threadBuffer returns the calling thread's buffer. A thread takes over the buffer of
+    // one that has exited, once that holds nothing for the current capture (which may still
+    // be being written), so that threads coming and going don't pile up buffers.
+    ThreadBuffer*
+    threadBuffer() noexcept
+    {
+        if (threadState.buffer_ != nullptr) {
+            return threadState.buffer_;
+        }
+        const std::lock_guard<std::mutex> lock(profiler.mutex_);
+        const uint64_t capture = profiler.capture_.load(std::memory_order_relaxed);
+        for (const auto& buffer : profiler.threads_) {
+            bool inUse = false;
+            if ((buffer->capture_.load(std::memory_order_relaxed) != capture ||
+                 buffer->count_.load(std::memory_order_relaxed) == 0) &&
+                buffer->inUse_.compare_exchange_strong(inUse, true, std::memory_order_acquire)) {
+                threadState.buffer_ = buffer.get();
+                break;
+            }
+        }
+        if (threadState.buffer_ == nullptr) {
+            profiler.threads_.push_back(std::make_unique<ThreadBuffer>());
+            threadState.buffer_ = profiler.threads_.back().get();
+        }
+        threadState.buffer_->tid_ = ++profiler.lastTid_;
+        return threadState.buffer_;
+    }
+
+    uint32_t
+    intern(const char* name) noexcept
+    {
+        const auto hash = (static_cast<uint64_t>(reinterpret_cast<uintptr_t>(name)) *
+                           0x9E3779B97F4A7C15ULL) >>
+                          (64U - NameCacheBits);
+        NameCacheEntry& entry = threadState.cache_[hash];
+        if (entry.key_ != name || std::strcmp(entry.copy_, name) != 0) {
+            entry.key_ = name;
+            entry.id_  = profiler.names_.Intern(name, &entry.copy_);
+        }
+        return entry.id_;
+    }
+
+    void
+    record(const Event& event) noexcept
+    {
+        ThreadBuffer*  buffer  = threadBuffer();
+        const uint64_t capture = profiler.capture_.load(std::memory_order_acquire);
+        if (buffer->capture_.load(std::memory_order_relaxed) != capture) {
+            buffer->count_.store(0, std::memory_order_relaxed);
+            buffer->dropped_.store(0, std::memory_order_relaxed);
+            buffer->capture_.store(capture, std::memory_order_relaxed);
+        }
+
+        const size_t count = buffer->count_.load(std::memory_order_relaxed);
+        const size_t chunk = count / EventsPerChunk;
+        if (chunk >= MaxChunks) {
+            buffer->dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        Event* events = buffer->chunks_[chunk].load(std::memory_order_relaxed);
+        if (events == nullptr) {
+            events = new Event[EventsPerChunk];
+            buffer->chunks_[chunk].store(events, std::memory_order_release);
+        }
+        events[count % EventsPerChunk] = event;
+        buffer->count_.store(count + 1, std::memory_order_release);
+    }
+
+    // TraceSnapshot is what the trace writer needs of a finished capture. The buffers'
+    // chunks aren't touched again until the next capture, which waits for the writer.
+    struct TraceThread
+    {
+        uint32_t                  tid_{0};
+        bool                      ui_{false};
+        size_t                    count_{0};
+        std::vector<const Event*> chunks_;
+    };
+
+    struct TraceSnapshot
+    {
+        std::string              path_;
+        int                      frames_{0};
+        uint64_t                 epoch_{0};
+        std::vector<TraceThread> threads_;
+        std::vector<const char*> names_;
+    };
+
+    void
+    writeJsonString(FILE* out, const char* text) noexcept
+    {
+        (void) fputc('"', out);
+        for (const char* c = text; *c != '\0'; ++c) {
+            const auto ch = static_cast<unsigned char>(*c);
+            if (ch == '"' || ch == '\\') {
+                (void) fputc('\\', out);
+                (void) fputc(ch, out);
+            } else if (ch < 0x20) {
+                (void) fprintf(out, "\\u%04x", ch);
+            } else {
+                (void) fputc(ch, out);
+            }
+        }
+        (void) fputc('"', out);
+    }
+
+    // writeTrace writes a capture's zones, on the trace writer's thread.
+    void
+    writeTrace(const TraceSnapshot& trace) noexcept
+    {
+        FILE* out = fopen(trace.path_.c_str(), "wb");
+        if (out == nullptr) {
+            (void) fprintf(stderr, "imguiwrap: couldn't write profile to %s\n",
+                           trace.path_.c_str());
+            return;
+        }
+
+        uint64_t events{0};
+        bool     first{true};
+        (void) fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", out);
+        for (const TraceThread& thread : trace.threads_) {
+            (void) fprintf(out,
+                           "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                           "\"args\":{\"name\":",
+                           first ? "" : ",", thread.tid_);
+            first = false;
+            if (thread.ui_) {
+                (void) fputs("\"UI\"}}", out);
+            } else {
+                (void) fprintf(out, "\"Thread %u\"}}", thread.tid_);
+            }
+
+            for (size_t i = 0; i < thread.count_; ++i) {
+                // A zone entered during the previous capture may have ended in this one.
+                const Event&   event = thread.chunks_[i / EventsPerChunk][i % EventsPerChunk];
+                const uint64_t start = std::max(event.start_, trace.epoch_);
+                (void) fputs(",\n{\"name\":", out);
+                writeJsonString(out,
+                                event.name_ < trace.names_.size() ? trace.names_[event.name_] : "");
+                (void) fprintf(out,
+                               ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                               thread.tid_,
+                               static_cast<double>(start - trace.epoch_) / 1000.0,
+                               static_cast<double>(event.end_ - start) / 1000.0);
+            }
+            events += thread.count_;
+        }
+
+        (void) fputs("\n]}\n", out);
+        if (fclose(out) != 0) {
+            (void) fprintf(stderr, "imguiwrap: error writing profile to %s\n",
+                           trace.path_.c_str());
+            return;
+        }
+        (void) fprintf(stderr, "imguiwrap: wrote %llu zones from %d frames to %s\n",
+                       static_cast<unsigned long long>(events), trace.frames_,
+                       trace.path_.c_str());
+    }
+
+    // TraceWriter formats and writes traces on a background thread, so that a big capture
+    // doesn't stall the frame it ends on, or threads recording zones.
+    class TraceWriter
+    {
+    public:
+        // Submit hands a snapshot to the writer thread, starting it if need be.
+        void Submit(TraceSnapshot&& trace) noexcept
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                pending_    = std::move(trace);
+                hasPending_ = true;
+                busy_       = true;
+            }
+            if (!thread_.joinable()) {
+                thread_ = std::thread([this] { run(); });
+            }
+            wake_.notify_one();
+        }
+
+        // Busy is true from Submit until the trace has been written.
+        bool Busy() noexcept
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return busy_;
+        }
+
+        // Stop finishes writing any trace and then joins the writer thread.
+        void Stop() noexcept
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_one();
+            if (thread_.joinable()) {
+                thread_.join();
+            }
+            stopping_ = false;
+        }
+
+    private:
+        void run() noexcept
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            for (;;) {
+                wake_.wait(lock, [this] { return hasPending_ || stopping_; });
+                if (!hasPending_) {
+                    break;  // stopping, with nothing left to write.
+                }
+                TraceSnapshot trace = std::move(pending_);
+                hasPending_         = false;
+                lock.unlock();
+
+                writeTrace(trace);
+
+                lock.lock();
+                busy_ = hasPending_;
+            }
+        }
+
+        std::mutex              mutex_;
+        std::condition_variable wake_;
+        TraceSnapshot           pending_;  // guarded by mutex_
+        bool                    hasPending_{false};
+        bool                    busy_{false};
+        bool                    stopping_{false};
+
+        std::thread thread_;
+    };
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    TraceWriter traceWriter;
+
+    // snapshotTrace collects the current capture's buffers and names for the writer. Other
+    // threads may still be running, but only ever append to their buffers.
+    TraceSnapshot
+    snapshotTrace() noexcept
+    {
+        TraceSnapshot trace;
+        trace.path_   = profiler.path_;
+        trace.frames_ = profiler.frames_;
+        trace.epoch_  = profiler.epoch_;
+
+        const uint64_t capture = profiler.capture_.load(std::memory_order_relaxed);
+        {
+            const std::lock_guard<std::mutex> lock(profiler.mutex_);
+            for (const auto& buffer : profiler.threads_) {
+                if (buffer->capture_.load(std::memory_order_relaxed) != capture) {
+                    continue;
+                }
+                const size_t count = buffer->count_.load(std::memory_order_acquire);
+                if (count == 0) {
+                    continue;
+                }
+                TraceThread thread;
+                thread.tid_   = buffer->tid_;
+                thread.ui_    = buffer.get() == profiler.uiThread_;
+                thread.count_ = count;
+                for (size_t chunk = 0; chunk * EventsPerChunk < count; ++chunk) {
+                    thread.chunks_.push_back(
+                        buffer->chunks_[chunk].load(std::memory_order_acquire));
+                }
+                trace.threads_.push_back(std::move(thread));
+            }
+        }
+        // After the counts, so that every name the events refer to is included.
+        profiler.names_.Snapshot(trace.names_);
+        return trace;
+    }
+
+}  // namespace
+
+namespace dear
+{
+    void CaptureProfile(int frames, const char* path) noexcept
+    {
+        if (profiler.recording_.load() || profiler.pendingFrames_ > 0 || frames <= 0) {
+            return;
+        }
+        profiler.pendingFrames_ = frames;
+        profiler.path_          = path;
+    }
+
+    ProfileStats GetProfileStats() noexcept
+    {
+        ProfileStats   stats{};
+        const uint64_t capture = profiler.capture_.load(std::memory_order_relaxed);
+        stats.capturing_       = profiler.recording_.load(std::memory_order_relaxed);
+        stats.frames_          = profiler.frames_;
+
+        const std::lock_guard<std::mutex> lock(profiler.mutex_);
+        for (const auto& buffer : profiler.threads_) {
+            if (buffer->capture_.load(std::memory_order_relaxed) != capture) {
+                continue;
+            }
+            const size_t count = buffer->count_.load(std::memory_order_relaxed);
+            stats.events_ += count;
+            stats.dropped_ += buffer->dropped_.load(std::memory_order_relaxed);
+            stats.threads_ += count > 0 ? 1 : 0;
+        }
+        return stats;
+    }
+
+    namespace detail
+    {
+        void ProfileBegin(const char* name) noexcept
+        {
+            ThreadState& state = threadState;
+            if (state.depth_ < MaxDepth) {
+                // Zones are only timed, and their names copied, while capturing.
+                const bool recording =
+                    name != nullptr && profiler.recording_.load(std::memory_order_relaxed);
+                state.names_[state.depth_]  = recording ? intern(name) : NoName;
+                state.starts_[state.depth_] = recording ? now() : 0;
+            }
+            ++state.depth_;
+        }
+
+        void ProfileEnd() noexcept
+        {
+            ThreadState& state = threadState;
+            if (state.depth_ == 0) {
+                return;
+            }
+            --state.depth_;
+            if (state.depth_ >= MaxDepth || state.names_[state.depth_] == NoName ||
+                !profiler.recording_.load(std::memory_order_relaxed)) {
+                return;
+            }
+            record(Event{state.starts_[state.depth_], now(), state.names_[state.depth_],
+                         static_cast<uint32_t>(state.depth_)});
+        }
+
+        void ProfileFrameBegin() noexcept
+        {
+            // The next capture reuses the buffers, so it waits until the last is written.
+            if (profiler.pendingFrames_ > 0 && !traceWriter.Busy()) {
+                profiler.uiThread_   = threadBuffer();
+                profiler.framesLeft_ = profiler.pendingFrames_;
+                profiler.frames_     = 0;
+                profiler.epoch_      = now();
+                profiler.capture_.fetch_add(1, std::memory_order_release);
+                profiler.recording_.store(true, std::memory_order_release);
+                profiler.pendingFrames_ = 0;
+            }
+            ProfileBegin("Frame");
+        }
+
+        void ProfileFrameEnd() noexcept
+        {
+            ProfileEnd();
+            if (!profiler.recording_.load(std::memory_order_relaxed)) {
+                return;
+            }
+            ++profiler.frames_;
+            if (--profiler.framesLeft_ == 0) {
+                profiler.recording_.store(false, std::memory_order_release);
+                traceWriter.Submit(snapshotTrace());
+            }
+        }
+
+        void ProfileStop() noexcept { traceWriter.Stop(); }
+    }  // namespace detail
+}  // namespace dear
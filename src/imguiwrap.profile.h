@@ -0,0 +1,66 @@
+#pragma once
+
+// Profiling zones, built with the IMGUIWRAP_PROFILING cmake option.
+//
+// In profiling builds every labelled dear:: scope (Begin, Child, Table, TreeNode,
+// TabItem, ...) and every dear::Zone records when it was entered and left; a scope's zone
+// takes in its ImGui::Begin... call as well as its End. Nothing is kept until you ask for
+// a capture, which records the zones of a range of frames, from any thread, into
+// per-thread buffers and then writes them out as Chrome trace-event JSON, for
+// chrome://tracing or https://ui.perfetto.dev:
+//
+//   if (ImGui::Button("Profile 60 frames")) {
+//       dear::CaptureProfile(60, "ui.trace.json");
+//   }
+//
+// Without the option, none of this exists and dear::Zone compiles to nothing.
+
+#ifdef IMGUIWRAP_PROFILING
+
+#    include <cstddef>
+#    include <cstdint>
+
+namespace dear
+{
+    // ProfileStats describes the current or most recent capture.
+    struct ProfileStats
+    {
+        // capturing_ is true while frames are being recorded.
+        bool capturing_{false};
+
+        // frames_ counts the frames recorded so far, events_ the zones recorded, and
+        // dropped_ the zones that didn't fit in their thread's buffer.
+        int      frames_{0};
+        uint64_t events_{0};
+        uint64_t dropped_{0};
+
+        // threads_ is the number of threads that recorded zones.
+        size_t threads_{0};
+    };
+
+    // CaptureProfile records the zones of the next 'frames' frames and then writes them to
+    // path as a Chrome trace, on a background thread. Calls made while a capture is running
+    // are ignored; one made while the last trace is still being written starts once it has
+    // been.
+    extern void CaptureProfile(int frames, const char* path) noexcept;
+
+    // GetProfileStats returns the state of the current or last capture.
+    extern ProfileStats GetProfileStats() noexcept;
+
+    namespace detail
+    {
+        // ProfileBegin/ProfileEnd are called by the scope hooks (see ScopeEnter); a null
+        // name is a transparent scope and isn't recorded.
+        extern void ProfileBegin(const char* name) noexcept;
+        extern void ProfileEnd() noexcept;
+
+        // imgui_main brackets each frame with these.
+        extern void ProfileFrameBegin() noexcept;
+        extern void ProfileFrameEnd() noexcept;
+
+        // ProfileStop waits for a trace that is still being written, at shutdown.
+        extern void ProfileStop() noexcept;
+    }  // namespace detail
+}  // namespace dear
+
+#endif  // IMGUIWRAP_PROFILING
@@ -0,0 +1,52 @@
+#include "imguiwrap.published.h"
+
+#include <vector>
+
+namespace
+{
+    struct PublishedEntry
+    {
+        void* published_;
+        void (*acquire_)(void*);
+    };
+
+    // publishedEntries lists the Published objects that exist, only touched on the UI
+    // thread. It is constructed on first use, so Published objects with static storage
+    // duration can attach themselves whatever order their translation units are
+    // initialized in.
+    std::vector<PublishedEntry>&
+    publishedEntries() noexcept
+    {
+        static std::vector<PublishedEntry> entries;
+        return entries;
+    }
+}  // namespace
+
+namespace dear
+{
+    namespace detail
+    {
+        void PublishedAttach(void* published, void (*acquire)(void*)) noexcept
+        {
+            publishedEntries().push_back(PublishedEntry{published, acquire});
+        }
+
+        void PublishedDetach(void* published) noexcept
+        {
+            std::vector<PublishedEntry>& entries = publishedEntries();
+            for (auto it = entries.begin(); it != entries.end(); ++it) {
+                if (it->published_ == published) {
+                    (void) entries.erase(it);
+                    return;
+                }
+            }
+        }
+
+        void PublishedFrameBegin() noexcept
+        {
+            for (const PublishedEntry& entry : publishedEntries()) {
+                entry.acquire_(entry.published_);
+            }
+        }
+    }  // namespace detail
+}  // namespace dear
@@ -0,0 +1,213 @@
+#pragma once
+
+// dear::Published shares snapshots of state produced on other threads (a simulation, a
+// network feed) with the UI, without either side waiting for the other:
+//
+//   struct SimState { double time_; ImVec2 bodies_[64]; };
+//   static dear::Published<SimState> sim;       // created on the UI thread
+//
+//   // simulation thread(s), at whatever rate they run:
+//   sim.Publish(state);                          // or sim.Write([&](SimState& s) { ... });
+//
+//   // in mainFn:
+//   const SimState& state = sim.Get();           // the same snapshot all frame
+//   dear::Cached("bodies", sim.Version()) && [&] { ... };
+//
+// Each Published<T> keeps maxWriters + 2 copies of T: one for each writer that may be
+// filling one at the same time, one holding the newest complete snapshot, and one being
+// read by the UI. A writer claims a free copy, fills it and swaps it in as the newest in
+// one atomic exchange; if the UI hadn't taken the snapshot it replaced, that copy is freed
+// again (and counted as dropped). Writers never wait for the UI or for each other, unless
+// more than maxWriters of them publish at once, in which case the extra ones spin until a
+// copy is free.
+//
+// imgui_main acquires the newest snapshot of every Published at the top of each frame, so
+// Get() returns the same consistent state for the whole frame, and Version() changes only
+// when a new snapshot has been taken. Outside imgui_main, call Acquire() yourself.
+//
+// Create and destroy Published objects on the UI thread; T has to be default
+// constructible and copy or move assignable.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace dear
+{
+    namespace detail
+    {
+        // PublishedAttach registers a Published for imgui_main to acquire every frame, and
+        // PublishedDetach removes it. Both are called on the UI thread.
+        extern void PublishedAttach(void* published, void (*acquire)(void*)) noexcept;
+        extern void PublishedDetach(void* published) noexcept;
+
+        // PublishedFrameBegin acquires the newest snapshot of every Published; imgui_main
+        // calls it at the top of each frame.
+        extern void PublishedFrameBegin() noexcept;
+    }  // namespace detail
+
+    // PublishedStats describes the snapshots that have passed through a Published.
+    struct PublishedStats
+    {
+        // published_ snapshots were completed by writers; acquired_ were taken by the UI,
+        // and dropped_ were replaced before it could take them.
+        uint64_t published_{0};
+        uint64_t acquired_{0};
+        uint64_t dropped_{0};
+
+        // writerSpins_ counts the claims in which a writer found no free copy and had to
+        // wait, however long it waited.
+        uint64_t writerSpins_{0};
+    };
+
+    template<typename T>
+    class Published
+    {
+    public:
+        // MaxCopies is the limit on maxWriters + 2, from the width of the free-copy mask.
+        static constexpr int MaxCopies = 32;
+
+        explicit Published(int maxWriters = 1) noexcept
+            : copies_(std::min(std::max(maxWriters, 1) + 2, MaxCopies))
+            , slots_(new Slot[static_cast<size_t>(copies_)])
+            // Copy 0 starts out as the UI's, and as the (already taken) newest snapshot.
+            , free_(static_cast<uint32_t>((uint64_t{1} << copies_) - 2))
+        {
+            detail::PublishedAttach(this, &acquire);
+        }
+
+        ~Published() { detail::PublishedDetach(this); }
+
+        Published(const Published&) = delete;
+        Published& operator=(const Published&) = delete;
+
+        // Publish makes a copy of value the newest snapshot. Any thread.
+        void Publish(const T& value) noexcept
+        {
+            Write([&value](T& snapshot) { snapshot = value; });
+        }
+
+        void Publish(T&& value) noexcept
+        {
+            Write([&value](T& snapshot) { snapshot = std::move(value); });
+        }
+
+        // Write calls fill with a T to overwrite with the new snapshot, then publishes it.
+        // The T holds an older snapshot, which may be useful for reusing its allocations,
+        // but isn't necessarily the newest one. Any thread.
+        template<typename FillFn>
+        void Write(FillFn&& fill) noexcept
+        {
+            const uint32_t copy = claim();
+            std::forward<FillFn>(fill)(slots_[copy].value_);
+            const uint32_t previous = newest_.exchange(copy | Fresh, std::memory_order_acq_rel);
+            if ((previous & Fresh) != 0) {
+                // The UI never saw the snapshot we replaced, so nobody else can be using it.
+                release(previous & ~Fresh);
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+            published_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Acquire takes the newest snapshot for Get, if there is a new one since the last
+        // call, releasing the previous one. UI thread.
+        bool Acquire() noexcept
+        {
+            uint32_t newest = newest_.load(std::memory_order_acquire);
+            while ((newest & Fresh) != 0) {
+                if (newest_.compare_exchange_weak(newest, newest & ~Fresh,
+                                                  std::memory_order_acq_rel,
+                                                  std::memory_order_acquire)) {
+                    release(front_);
+                    front_ = newest & ~Fresh;
+                    ++acquired_;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Get returns the snapshot taken by the last Acquire, or a default constructed T
+        // if nothing has been published yet. UI thread.
+        const T& Get() const noexcept { return slots_[front_].value_; }
+
+        // Version is the number of snapshots acquired so far, for use as a dear::Memo or
+        // dear::Cached version.
+        uint64_t Version() const noexcept { return acquired_; }
+
+        PublishedStats Stats() const noexcept
+        {
+            PublishedStats stats{};
+            stats.published_   = published_.load(std::memory_order_relaxed);
+            stats.acquired_    = acquired_;
+            stats.dropped_     = dropped_.load(std::memory_order_relaxed);
+            stats.writerSpins_ = writerSpins_.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+    private:
+        // Fresh marks newest_ when the UI hasn't taken that snapshot yet.
+        static constexpr uint32_t Fresh = 0x80000000U;
+
+        // Each copy gets its own cache lines, so writers filling neighboring copies don't
+        // contend for them.
+        struct alignas(64) Slot
+        {
+            T value_{};
+        };
+
+        static void acquire(void* published) noexcept
+        {
+            (void) static_cast<Published*>(published)->Acquire();
+        }
+
+        // claim takes a free copy for a writer, spinning if there are none.
+        uint32_t claim() noexcept
+        {
+            uint32_t mask    = free_.load(std::memory_order_relaxed);
+            bool     counted = false;
+            for (;;) {
+                if (mask == 0) {
+                    if (!counted) {
+                        writerSpins_.fetch_add(1, std::memory_order_relaxed);
+                        counted = true;
+                    }
+                    std::this_thread::yield();
+                    mask = free_.load(std::memory_order_relaxed);
+                    continue;
+                }
+                const uint32_t lowest = mask & (~mask + 1);
+                if (free_.compare_exchange_weak(mask, mask & ~lowest, std::memory_order_acquire,
+                                                std::memory_order_relaxed)) {
+                    uint32_t copy = 0;
+                    while ((lowest >> copy) != 1) {
+                        ++copy;
+                    }
+                    return copy;
+                }
+            }
+        }
+
+        void release(uint32_t copy) noexcept
+        {
+            (void) free_.fetch_or(uint32_t{1} << copy, std::memory_order_release);
+        }
+
+        const int               copies_;
+        std::unique_ptr<Slot[]> slots_;  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+
+        alignas(64) std::atomic<uint32_t> free_;       // bit n set if copy n is free
+        alignas(64) std::atomic<uint32_t> newest_{0};  // newest snapshot's copy, plus Fresh
+
+        std::atomic<uint64_t> published_{0};
+        std::atomic<uint64_t> dropped_{0};
+        std::atomic<uint64_t> writerSpins_{0};
+
+        // UI thread.
+        alignas(64) uint32_t front_{0};
+        uint64_t acquired_{0};
+    };
+}  // namespace dear
@@ -0,0 +1,111 @@
+// Per-thread stack of active dear:: scope labels, used by instrumented builds to
+// attribute costs (allocations, time, geometry) to the scope that incurred them.
+
+#include "imguiwrap.dear.h"
+#include "imguiwrap.drawcost.h"
+#include "imguiwrap.profile.h"
+
+#ifdef IMGUIWRAP_SCOPE_HOOKS
+
+#    include <algorithm>
+#    include <array>
+#    include <cstring>
+
+namespace
+{
+    // Scopes nested deeper than this are still balanced, but their labels are not kept.
+    constexpr size_t MaxScopeDepth = 64;
+
+    struct ScopeStack
+    {
+        std::array<const char*, MaxScopeDepth> labels_;
+        size_t                                 depth_;
+    };
+
+    thread_local ScopeStack scopeStack{};
+
+}  // namespace
+
+namespace dear
+{
+    namespace detail
+    {
+        void ScopeEnter(const char* label) noexcept
+        {
+            if (scopeStack.depth_ < MaxScopeDepth) {
+                scopeStack.labels_[scopeStack.depth_] = label;
+            }
+            ++scopeStack.depth_;
+#ifdef IMGUIWRAP_PROFILING
+            ProfileBegin(label);
+#endif
+#ifdef IMGUIWRAP_DRAW_COST
+            DrawCostEnter(label);
+#endif
+        }
+
+        void ScopeExit() noexcept
+        {
+#ifdef IMGUIWRAP_DRAW_COST
+            DrawCostExit();
+#endif
+#ifdef IMGUIWRAP_PROFILING
+            ProfileEnd();
+#endif
+            if (scopeStack.depth_ > 0) {
+                --scopeStack.depth_;
+            }
+        }
+
+        const char* CurrentScopeLabel() noexcept
+        {
+            for (size_t i = std::min(scopeStack.depth_, MaxScopeDepth); i > 0; --i) {
+                if (scopeStack.labels_[i - 1] != nullptr) {
+                    return scopeStack.labels_[i - 1];
+                }
+            }
+            return nullptr;
+        }
+
+        size_t FormatScopePath(char* buffer, size_t bufferSize) noexcept
+        {
+            if (bufferSize == 0) {
+                return 0;
+            }
+
+            // Walk outwards to find how many of the innermost labels fit.
+            const size_t depth = std::min(scopeStack.depth_, MaxScopeDepth);
+            size_t       first = depth;
+            size_t       total = 0;
+            while (first > 0) {
+                const char* label = scopeStack.labels_[first - 1];
+                if (label != nullptr) {
+                    const size_t needed = std::strlen(label) + (total > 0 ? 1 : 0);
+                    if (total + needed >= bufferSize) {
+                        break;
+                    }
+                    total += needed;
+                }
+                --first;
+            }
+
+            size_t length = 0;
+            for (size_t i = first; i < depth; ++i) {
+                const char* label = scopeStack.labels_[i];
+                if (label == nullptr) {
+                    continue;
+                }
+                if (length > 0) {
+                    buffer[length++] = '/';
+                }
+                const size_t labelLength = std::strlen(label);
+                std::memcpy(buffer + length, label, labelLength);
+                length += labelLength;
+            }
+            buffer[length] = '\0';
+            return length;
+        }
+    }  // namespace detail
+}  // namespace dear
+
+#endif  // IMGUIWRAP_SCOPE_HOOKS
@@ -0,0 +1,215 @@
+#pragma once
+
+// Producer side of dear::SharedSeries: publishes samples of a fixed set of float channels
+// into a POSIX shared-memory ring buffer that imguiwrap UIs on the same host map and read
+// in place.
+//
+// This header is self-contained (it doesn't need imgui or the imguiwrap library), so it
+// can be dropped into the processes that generate the metrics:
+//
+//   const char* channels[] = {"cpu", "queue depth", "latency ms"};
+//   dear::SeriesProducer producer("myservice.metrics", channels, 3);
+//   ...
+//   const float sample[] = {cpu, float(queue.size()), latencyMs};
+//   producer.Push(sample);
+//
+// There must be one producer per series; Push is wait-free and never blocks on readers.
+// Destroying the producer removes the name, although readers that already have it mapped
+// keep their mapping.
+//
+// Layout: a SeriesLayout header followed by 'capacity' floats per channel. Sample 'n' of
+// channel 'c' lives at values[c * capacity + (n % capacity)]. The producer bumps claimed_
+// before overwriting a slot and written_ once the new samples are complete, so readers
+// know which samples are complete and can tell afterwards whether any they used were
+// overwritten while they were reading them.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if !defined(_WIN32)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <unistd.h>
+#endif
+
+namespace dear
+{
+    struct SeriesLayout
+    {
+        static constexpr uint32_t Magic       = 0x53534749;  // "IGSS"
+        static constexpr uint32_t Version     = 1;
+        static constexpr size_t   MaxChannels = 32;
+        static constexpr size_t   NameLength  = 32;
+        static constexpr size_t   MaxName     = 200;
+
+        // magic_ is stored last, so readers never see a half-initialized header.
+        std::atomic<uint32_t> magic_;
+        uint32_t              version_;
+        uint32_t              channels_;
+        uint32_t              capacity_;  // a power of two
+        char                  names_[MaxChannels][NameLength];
+
+        // Counters are kept on their own cache lines: the producer writes them constantly.
+        alignas(64) std::atomic<uint64_t> claimed_;  // samples the producer has started on
+        alignas(64) std::atomic<uint64_t> written_;  // samples that are complete
+
+        // Values follow the header, at the first cache line after it.
+        static constexpr size_t DataOffset() noexcept
+        {
+            return (sizeof(SeriesLayout) + 63) & ~size_t{63};
+        }
+
+        static constexpr size_t Bytes(size_t channels, size_t capacity) noexcept
+        {
+            return DataOffset() + channels * capacity * sizeof(float);
+        }
+
+        // ShmName formats the shared-memory object name for a series name into buffer,
+        // returning false if it doesn't fit.
+        static bool ShmName(const char* name, char (&buffer)[MaxName + 2]) noexcept
+        {
+            const size_t length = name != nullptr ? strlen(name) : 0;
+            if (length == 0 || length > MaxName) {
+                return false;
+            }
+            buffer[0] = '/';
+            memcpy(buffer + 1, name, length + 1);
+            return true;
+        }
+    };
+
+    // The counters have to work between processes.
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "needs lock-free 64-bit atomics");
+
+    class SeriesProducer
+    {
+    public:
+        SeriesProducer() noexcept = default;
+        SeriesProducer(const char* name, const char* const* channelNames, size_t channels,
+                       size_t capacity = DefaultCapacity) noexcept
+        {
+            (void) Create(name, channelNames, channels, capacity);
+        }
+        ~SeriesProducer() { Close(); }
+
+        SeriesProducer(const SeriesProducer&) = delete;
+        SeriesProducer& operator=(const SeriesProducer&) = delete;
+
+        static constexpr size_t DefaultCapacity = 65536;
+
+        // Create publishes a new series called 'name', replacing any stale one of the same
+        // name. capacity is rounded up to a power of two. Returns false on failure, or on
+        // platforms without POSIX shared memory.
+        bool Create(const char* name, const char* const* channelNames, size_t channels,
+                    size_t capacity = DefaultCapacity) noexcept
+        {
+            Close();
+            char shmName[SeriesLayout::MaxName + 2];
+            if (channels == 0 || channels > SeriesLayout::MaxChannels || capacity == 0 ||
+                capacity > (size_t{1} << 30) || !SeriesLayout::ShmName(name, shmName)) {
+                return false;
+            }
+            size_t slots = 1;
+            while (slots < capacity) {
+                slots <<= 1;
+            }
+#if defined(_WIN32)
+            (void) channelNames;
+            return false;
+#else
+            const size_t bytes = SeriesLayout::Bytes(channels, slots);
+            (void) shm_unlink(shmName);
+            const int fd = shm_open(shmName, O_CREAT | O_EXCL | O_RDWR, 0644);
+            if (fd < 0) {
+                return false;
+            }
+            void* base = MAP_FAILED;
+            if (ftruncate(fd, static_cast<off_t>(bytes)) == 0) {
+                base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            }
+            (void) close(fd);
+            if (base == MAP_FAILED) {
+                (void) shm_unlink(shmName);
+                return false;
+            }
+
+            // The new object is zero-filled, so only the fields need setting.
+            auto* layout      = static_cast<SeriesLayout*>(base);
+            layout->version_  = SeriesLayout::Version;
+            layout->channels_ = static_cast<uint32_t>(channels);
+            layout->capacity_ = static_cast<uint32_t>(slots);
+            for (size_t c = 0; channelNames != nullptr && c < channels; ++c) {
+                if (channelNames[c] != nullptr) {
+                    strncpy(layout->names_[c], channelNames[c], SeriesLayout::NameLength - 1);
+                }
+            }
+            layout->magic_.store(SeriesLayout::Magic, std::memory_order_release);
+
+            char* data = static_cast<char*>(base) + SeriesLayout::DataOffset();
+            layout_    = layout;
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            values_    = reinterpret_cast<float*>(data);
+            bytes_     = bytes;
+            channels_  = channels;
+            mask_      = slots - 1;
+            memcpy(name_, shmName, strlen(shmName) + 1);
+            return true;
+#endif
+        }
+
+        void Close() noexcept
+        {
+#if !defined(_WIN32)
+            if (layout_ != nullptr) {
+                (void) munmap(layout_, bytes_);
+                (void) shm_unlink(name_);
+            }
+#endif
+            layout_ = nullptr;
+            values_ = nullptr;
+        }
+
+        bool   IsOpen() const noexcept { return layout_ != nullptr; }
+        size_t Channels() const noexcept { return channels_; }
+
+        // Push publishes one sample, with a value for every channel.
+        void Push(const float* values) noexcept { Push(values, 1); }
+
+        // Push publishes 'count' samples at once, stored sample-major (all the channels of
+        // the first sample, then the second, ...); cheaper than pushing them one by one.
+        void Push(const float* samples, size_t count) noexcept
+        {
+            if (layout_ == nullptr || count == 0) {
+                return;
+            }
+            const size_t capacity = mask_ + 1;
+            if (count > capacity) {
+                samples += (count - capacity) * channels_;
+                count = capacity;
+            }
+            // Only the producer writes the counters, so it can read its own without ordering.
+            const uint64_t first = layout_->written_.load(std::memory_order_relaxed);
+            const uint64_t end   = first + count;
+            layout_->claimed_.store(end, std::memory_order_relaxed);
+            // Readers have to see the claim before any of the overwrites.
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t c = 0; c < channels_; ++c) {
+                float* channel = values_ + c * capacity;
+                for (uint64_t n = first; n < end; ++n) {
+                    channel[n & mask_] = samples[(n - first) * channels_ + c];
+                }
+            }
+            layout_->written_.store(end, std::memory_order_release);
+        }
+
+    private:
+        SeriesLayout* layout_{nullptr};
+        float*        values_{nullptr};
+        size_t        bytes_{0};
+        size_t        channels_{0};
+        size_t        mask_{0};
+        char          name_[SeriesLayout::MaxName + 2]{};
+    };
+}  // namespace dear
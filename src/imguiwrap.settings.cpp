@@ -0,0 +1,250 @@
+#include "imguiwrap.settings.h"
+#include "imguiwrap.mappedfile.h"
+
+#include "imgui.h"
+
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#if defined(_WIN32)
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <io.h>  // _commit
+#    include <windows.h>
+#else
+#    include <unistd.h>  // fsync
+#endif
+
+namespace
+{
+    // After the first snapshot of a burst arrives, the writer waits this long for newer
+    // ones, so that e.g. a sequence of column resizes results in a single write.
+    constexpr auto CoalesceDelay = std::chrono::milliseconds(250);
+
+    class SettingsWriter
+    {
+    public:
+        void Start(const char* path, std::string onDisk) noexcept
+        {
+            path_     = path;
+            tempPath_ = path_ + ".tmp";
+            written_  = std::move(onDisk);
+            stopping_ = false;
+            thread_   = std::thread([this] { run(); });
+        }
+
+        // Submit replaces any snapshot that hasn't been written yet. The buffers are
+        // reused, so once they have grown to fit the settings this doesn't allocate.
+        void Submit(const char* data, size_t size) noexcept
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                pending_.assign(data, size);
+                hasPending_ = true;
+                ++stats_.captures_;
+            }
+            wake_.notify_one();
+        }
+
+        // Stop writes any pending snapshot and then joins the writer thread.
+        void Stop() noexcept
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_one();
+            if (thread_.joinable()) {
+                thread_.join();
+            }
+        }
+
+        dear::SettingsStats Stats() noexcept
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return stats_;
+        }
+
+        void SetStats(bool active, bool loaded) noexcept
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.active_ = active;
+            stats_.loaded_ = loaded;
+        }
+
+    private:
+        void run() noexcept
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            for (;;) {
+                wake_.wait(lock, [this] { return hasPending_ || stopping_; });
+                if (!hasPending_) {
+                    break;  // stopping, with nothing left to write.
+                }
+                if (!stopping_) {
+                    (void) wake_.wait_for(lock, CoalesceDelay, [this] { return stopping_; });
+                }
+                writing_.swap(pending_);
+                hasPending_ = false;
+                lock.unlock();
+
+                bool       wrote = false, failed = false;
+                const auto start = std::chrono::steady_clock::now();
+                if (writing_ != written_) {
+                    failed = !writeFile();
+                    wrote  = !failed;
+                    if (wrote) {
+                        written_.swap(writing_);
+                    }
+                }
+                const std::chrono::duration<double, std::milli> elapsed =
+                    std::chrono::steady_clock::now() - start;
+
+                lock.lock();
+                if (wrote) {
+                    ++stats_.writes_;
+                    stats_.lastWriteMs_ = elapsed.count();
+                }
+                if (failed) {
+                    ++stats_.failures_;
+                }
+            }
+        }
+
+        // writeFile writes writing_ to a temporary file alongside the settings file and
+        // renames it into place, so that a crash mid-write can't leave a truncated file.
+        bool writeFile() noexcept
+        {
+            FILE* file = fopen(tempPath_.c_str(), "wb");
+            if (file == nullptr) {
+                return fail("open");
+            }
+            bool ok = fwrite(writing_.data(), 1, writing_.size(), file) == writing_.size();
+            ok      = ok && fflush(file) == 0;
+#if defined(_WIN32)
+            ok = ok && _commit(_fileno(file)) == 0;
+#else
+            ok = ok && fsync(fileno(file)) == 0;
+#endif
+            ok = (fclose(file) == 0) && ok;
+            if (!ok) {
+                (void) remove(tempPath_.c_str());
+                return fail("write");
+            }
+#if defined(_WIN32)
+            if (MoveFileExA(tempPath_.c_str(), path_.c_str(),
+                            MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) == 0) {
+#else
+            if (rename(tempPath_.c_str(), path_.c_str()) != 0) {
+#endif
+                (void) remove(tempPath_.c_str());
+                return fail("rename");
+            }
+            return true;
+        }
+
+        bool fail(const char* what) const noexcept
+        {
+            (void) fprintf(stderr, "imguiwrap: couldn't save settings to %s (%s): %s\n",
+                           path_.c_str(), what, strerror(errno));
+            return false;
+        }
+
+        std::string path_;
+        std::string tempPath_;
+
+        std::mutex              mutex_;
+        std::condition_variable wake_;
+        std::string             pending_;  // guarded by mutex_
+        bool                    hasPending_{false};
+        bool                    stopping_{false};
+        dear::SettingsStats     stats_{};
+
+        // Only touched by the writer thread.
+        std::string writing_;
+        std::string written_;  // what the file currently contains
+
+        std::thread thread_;
+    };
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    SettingsWriter settingsWriter;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    bool settingsActive{false};
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    bool saveRequested{false};
+
+    void
+    captureSettings() noexcept
+    {
+        size_t      size = 0;
+        const char* data = ImGui::SaveIniSettingsToMemory(&size);
+        settingsWriter.Submit(data, size);
+    }
+
+}  // namespace
+
+namespace dear
+{
+    SettingsStats GetSettingsStats() noexcept { return settingsWriter.Stats(); }
+
+    void SaveSettingsNow() noexcept { saveRequested = true; }
+
+    namespace detail
+    {
+        void SettingsStart(const char* path) noexcept
+        {
+            ImGuiIO& io    = ImGui::GetIO();
+            io.IniFilename = nullptr;
+
+            std::string onDisk;
+            bool        loaded = false;
+            if (MappedFile file(path); file.IsOpen() && file.Size() > 0) {
+                const auto* data = reinterpret_cast<const char*>(file.Data());
+                ImGui::LoadIniSettingsFromMemory(data, file.Size());
+                onDisk.assign(data, file.Size());
+                loaded = true;
+            }
+
+            settingsWriter.Start(path, std::move(onDisk));
+            settingsWriter.SetStats(true, loaded);
+            settingsActive = true;
+        }
+
+        void SettingsFrameEnd() noexcept
+        {
+            if (!settingsActive) {
+                return;
+            }
+            ImGuiIO& io = ImGui::GetIO();
+            if (!io.WantSaveIniSettings && !saveRequested) {
+                return;
+            }
+            io.WantSaveIniSettings = false;
+            saveRequested          = false;
+            captureSettings();
+        }
+
+        void SettingsStop() noexcept
+        {
+            if (!settingsActive) {
+                return;
+            }
+            // ImGui would have saved when the context was destroyed.
+            captureSettings();
+            settingsWriter.Stop();
+            settingsWriter.SetStats(false, false);
+            settingsActive = false;
+        }
+    }  // namespace detail
+}  // namespace dear
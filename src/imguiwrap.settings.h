@@ -0,0 +1,60 @@
+#pragma once
+
+// Asynchronous persistence of ImGui's settings (imgui.ini).
+//
+// By default ImGui writes imgui.ini itself, synchronously, from within NewFrame whenever
+// a window is moved or resized or a table column changes (throttled by io.IniSavingRate),
+// and again when the context is destroyed. On slow or network file systems that stalls
+// the UI thread.
+//
+// When ImGuiWrapConfig::asyncSettings_ is set, imgui_main instead clears io.IniFilename,
+// loads the file itself through a memory mapping before the first frame, and whenever
+// ImGui wants the settings saved, captures them with ImGui::SaveIniSettingsToMemory and
+// hands the text to a background thread. The writer coalesces bursts of saves, skips
+// writes that wouldn't change the file, and replaces the file atomically by writing to a
+// temporary file and renaming it over the original.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dear
+{
+    // SettingsStats reports what the background settings writer has done.
+    struct SettingsStats
+    {
+        // active_ is false unless imgui_main is running with asyncSettings_.
+        bool active_{false};
+
+        // loaded_ is true if settings were read from the file at startup.
+        bool loaded_{false};
+
+        // captures_ counts snapshots handed to the writer, writes_ the files actually
+        // written, and failures_ the writes that failed (reported to stderr).
+        uint64_t captures_{0};
+        uint64_t writes_{0};
+        uint64_t failures_{0};
+
+        // lastWriteMs_ is how long the last write took, off the UI thread.
+        double lastWriteMs_{0.0};
+    };
+
+    extern SettingsStats GetSettingsStats() noexcept;
+
+    // SaveSettingsNow asks for the settings to be captured at the end of the current frame,
+    // regardless of io.IniSavingRate. The write itself still happens in the background.
+    extern void SaveSettingsNow() noexcept;
+
+    namespace detail
+    {
+        // SettingsStart disables ImGui's own ini handling, loads 'path' and starts the
+        // writer thread. Call after ImGui::CreateContext and before the first NewFrame.
+        extern void SettingsStart(const char* path) noexcept;
+
+        // SettingsFrameEnd captures the settings if ImGui has asked for them to be saved.
+        extern void SettingsFrameEnd() noexcept;
+
+        // SettingsStop captures the final settings, waits for them to be written and
+        // stops the writer. Call before ImGui::DestroyContext.
+        extern void SettingsStop() noexcept;
+    }  // namespace detail
+}  // namespace dear
@@ -0,0 +1,163 @@
+#include "imguiwrap.sharedseries.h"
+
+#include <algorithm>
+
+#if !defined(_WIN32)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace
+{
+    struct PlotSource
+    {
+        const dear::SeriesView* view_;
+        size_t                  channel_;
+    };
+
+    float
+    plotValue(void* data, int index) noexcept
+    {
+        const auto* source = static_cast<const PlotSource*>(data);
+        return source->view_->At(source->channel_, static_cast<size_t>(index));
+    }
+
+}  // namespace
+
+namespace dear
+{
+    bool SharedSeries::Open(const char* name) noexcept
+    {
+        Close();
+#if defined(_WIN32)
+        (void) name;
+        return false;
+#else
+        char shmName[SeriesLayout::MaxName + 2];
+        if (!SeriesLayout::ShmName(name, shmName)) {
+            return false;
+        }
+        const int fd = shm_open(shmName, O_RDONLY, 0);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info
+        {};
+        void* base = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(SeriesLayout)) {
+            base = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        }
+        (void) close(fd);
+        if (base == MAP_FAILED) {
+            return false;
+        }
+
+        // Only read the header once the producer has finished writing it: the acquire load
+        // of magic_ must come before the reads of the fields it publishes.
+        const auto*  layout = static_cast<const SeriesLayout*>(base);
+        const size_t bytes  = static_cast<size_t>(info.st_size);
+        if (layout->magic_.load(std::memory_order_acquire) != SeriesLayout::Magic ||
+            layout->version_ != SeriesLayout::Version) {
+            (void) munmap(base, bytes);
+            return false;
+        }
+        const size_t channels = layout->channels_;
+        const size_t capacity = layout->capacity_;
+        if (channels == 0 || channels > SeriesLayout::MaxChannels || capacity == 0 ||
+            (capacity & (capacity - 1)) != 0 || SeriesLayout::Bytes(channels, capacity) > bytes) {
+            (void) munmap(base, bytes);
+            return false;
+        }
+
+        layout_ = layout;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        values_   = reinterpret_cast<const float*>(static_cast<const char*>(base) +
+                                                 SeriesLayout::DataOffset());
+        bytes_    = bytes;
+        channels_ = channels;
+        capacity_ = capacity;
+        return true;
+#endif
+    }
+
+    void SharedSeries::Close() noexcept
+    {
+#if !defined(_WIN32)
+        if (layout_ != nullptr) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast) munmap isn't const-correct.
+            (void) munmap(const_cast<SeriesLayout*>(layout_), bytes_);
+        }
+#endif
+        layout_   = nullptr;
+        values_   = nullptr;
+        channels_ = capacity_ = 0;
+    }
+
+    const char* SharedSeries::ChannelName(size_t channel) const noexcept
+    {
+        if (layout_ == nullptr || channel >= channels_) {
+            return "";
+        }
+        // The producer leaves the last byte of each name zero.
+        return layout_->names_[channel];
+    }
+
+    uint64_t SharedSeries::Written() const noexcept
+    {
+        return layout_ != nullptr ? layout_->written_.load(std::memory_order_acquire) : 0;
+    }
+
+    SeriesView SharedSeries::Since(uint64_t first) const noexcept
+    {
+        SeriesView view{};
+        if (layout_ == nullptr) {
+            return view;
+        }
+        // Everything up to written_ is complete; anything before claimed_ - capacity may
+        // already be being overwritten.
+        const uint64_t end     = layout_->written_.load(std::memory_order_acquire);
+        const uint64_t claimed = layout_->claimed_.load(std::memory_order_acquire);
+        const uint64_t oldest  = claimed > capacity_ ? claimed - capacity_ : 0;
+        view.values_           = values_;
+        view.capacity_         = capacity_;
+        view.end_              = end;
+        view.first_            = std::min(std::max(first, oldest), end);
+        return view;
+    }
+
+    SeriesView SharedSeries::Latest(size_t maxSamples) const noexcept
+    {
+        SeriesView view = Since(0);
+        if (view.Size() > maxSamples) {
+            view.first_ = view.end_ - maxSamples;
+        }
+        return view;
+    }
+
+    bool SharedSeries::Intact(const SeriesView& view) const noexcept
+    {
+        if (layout_ == nullptr) {
+            return false;
+        }
+        // Order the caller's reads of the values before re-reading the claim; sample n is
+        // overwritten once the producer claims sample n + capacity.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t claimed = layout_->claimed_.load(std::memory_order_relaxed);
+        return view.Empty() || claimed <= view.first_ + capacity_;
+    }
+
+    void SharedSeries::PlotLines(const char* label, size_t channel, size_t maxSamples, ImVec2 size,
+                                 float scaleMin, float scaleMax) const noexcept
+    {
+        if (channel >= channels_) {
+            ImGui::PlotLines(label, static_cast<const float*>(nullptr), 0);
+            return;
+        }
+        const SeriesView view = Latest(maxSamples);
+        PlotSource       source{&view, channel};
+        ImGui::PlotLines(label, plotValue, &source, static_cast<int>(view.Size()), 0, nullptr,
+                         scaleMin, scaleMax, size);
+    }
+}  // namespace dear
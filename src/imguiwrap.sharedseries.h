@@ -0,0 +1,112 @@
+#pragma once
+
+// dear::SharedSeries maps a series published by another process on the same host (see
+// imguiwrap.seriesproducer.h) and reads its samples where they are, without a socket,
+// parsing, or a copy per frame:
+//
+//   static dear::SharedSeries metrics("myservice.metrics");
+//   if (!metrics.IsOpen() && !metrics.Open("myservice.metrics"))
+//       return;
+//   metrics.PlotLines("cpu", 0, 1000);     // the last 1000 samples of channel 0
+//
+//   // or read them yourself, e.g. into a table with an ImGuiListClipper:
+//   const dear::SeriesView view = metrics.Latest(1000);
+//   for (size_t i = 0; i < view.Size(); ++i)
+//       sum += view.At(2, i);
+//   if (!metrics.Intact(view))
+//       ... the producer lapped us and some of those values may be torn; try again.
+//
+// Reading is lock-free: the producer never waits for readers, and readers never write to
+// the shared memory. A view only includes samples that were complete when it was taken,
+// and Intact() says whether any of them have been overwritten since, which only happens
+// when the producer writes more than the ring's capacity while you are reading.
+//
+// If the producer restarts, Open the series again to map the new instance. POSIX only;
+// Open fails on other platforms.
+
+#include "imgui.h"
+#include "imguiwrap.seriesproducer.h"
+
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+
+namespace dear
+{
+    // SeriesView is a range of samples of a SharedSeries, indexed from 0 (the oldest) to
+    // Size() - 1. It points into the shared memory, so it is only valid while the series
+    // stays open.
+    class SeriesView
+    {
+    public:
+        size_t Size() const noexcept { return static_cast<size_t>(end_ - first_); }
+        bool   Empty() const noexcept { return end_ == first_; }
+
+        // First and End are the sequence numbers of the samples in the view, for readers
+        // that want to process every sample once (see SharedSeries::Since).
+        uint64_t First() const noexcept { return first_; }
+        uint64_t End() const noexcept { return end_; }
+
+        float At(size_t channel, size_t index) const noexcept
+        {
+            return values_[channel * capacity_ + ((first_ + index) & (capacity_ - 1))];
+        }
+
+    private:
+        friend class SharedSeries;
+
+        const float* values_{nullptr};
+        size_t       capacity_{1};
+        uint64_t     first_{0};
+        uint64_t     end_{0};
+    };
+
+    class SharedSeries
+    {
+    public:
+        SharedSeries() noexcept = default;
+        explicit SharedSeries(const char* name) noexcept { (void) Open(name); }
+        ~SharedSeries() { Close(); }
+
+        SharedSeries(const SharedSeries&) = delete;
+        SharedSeries& operator=(const SharedSeries&) = delete;
+
+        // Open maps the series called 'name', closing any previous one. Returns false if no
+        // producer has published it (yet).
+        bool Open(const char* name) noexcept;
+        void Close() noexcept;
+
+        bool        IsOpen() const noexcept { return layout_ != nullptr; }
+        size_t      Channels() const noexcept { return channels_; }
+        size_t      Capacity() const noexcept { return capacity_; }
+        const char* ChannelName(size_t channel) const noexcept;
+
+        // Written is the number of samples published so far.
+        uint64_t Written() const noexcept;
+
+        // Latest is a view of the most recent samples, at most maxSamples of them.
+        SeriesView Latest(size_t maxSamples) const noexcept;
+
+        // Since is a view of the samples from sequence number 'first' on, or as many of them
+        // as are still in the ring; pass the End() of the previous view to see each sample
+        // once.
+        SeriesView Since(uint64_t first) const noexcept;
+
+        // Intact is true if none of the samples in view have been overwritten since it was
+        // taken; check it after reading them.
+        bool Intact(const SeriesView& view) const noexcept;
+
+        // PlotLines draws the last maxSamples samples of a channel with ImGui::PlotLines,
+        // reading them straight out of the ring.
+        void PlotLines(const char* label, size_t channel, size_t maxSamples,
+                       ImVec2 size = ImVec2(0.0F, 0.0F), float scaleMin = FLT_MAX,
+                       float scaleMax = FLT_MAX) const noexcept;
+
+    private:
+        const SeriesLayout* layout_{nullptr};
+        const float*        values_{nullptr};
+        size_t              bytes_{0};
+        size_t              channels_{0};
+        size_t              capacity_{0};
+    };
+}  // namespace dear
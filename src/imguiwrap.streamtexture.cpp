@@ -0,0 +1,346 @@
+// Streaming texture uploads from worker threads; see imguiwrap.streamtexture.h.
+
+#include "imguiwrap.streamtexture.h"
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+// GL entry points use the system calling convention, which only differs on 32-bit Windows.
+#ifdef _WIN32
+#    define IMGUIWRAP_GLAPI __stdcall
+#else
+#    define IMGUIWRAP_GLAPI
+#endif
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr unsigned int Texture2D         = 0x0DE1;  // GL_TEXTURE_2D
+    constexpr unsigned int TextureBinding2D  = 0x8069;  // GL_TEXTURE_BINDING_2D
+    constexpr unsigned int Rgba              = 0x1908;  // GL_RGBA
+    constexpr unsigned int UnsignedByte      = 0x1401;  // GL_UNSIGNED_BYTE
+    constexpr unsigned int TextureMinFilter  = 0x2801;  // GL_TEXTURE_MIN_FILTER
+    constexpr unsigned int TextureMagFilter  = 0x2800;  // GL_TEXTURE_MAG_FILTER
+    constexpr unsigned int TextureWrapS      = 0x2802;  // GL_TEXTURE_WRAP_S
+    constexpr unsigned int TextureWrapT      = 0x2803;  // GL_TEXTURE_WRAP_T
+    constexpr int          Linear            = 0x2601;  // GL_LINEAR
+    constexpr int          ClampToEdge       = 0x812F;  // GL_CLAMP_TO_EDGE
+    constexpr unsigned int PixelUnpackBuffer = 0x88EC;  // GL_PIXEL_UNPACK_BUFFER
+    constexpr unsigned int StreamDraw        = 0x88E0;  // GL_STREAM_DRAW
+    constexpr unsigned int MapWrite          = 0x0002;  // GL_MAP_WRITE_BIT
+    constexpr unsigned int MapInvalidate     = 0x0008;  // GL_MAP_INVALIDATE_BUFFER_BIT
+
+    // imgui's loader only has what its backend uses, so entry points are looked up through
+    // GLFW, as in imguiwrap.latency.cpp.
+    struct GlFunctions
+    {
+        using GenFn            = void(IMGUIWRAP_GLAPI*)(int count, unsigned int* names);
+        using DeleteFn         = void(IMGUIWRAP_GLAPI*)(int count, const unsigned int* names);
+        using BindFn           = void(IMGUIWRAP_GLAPI*)(unsigned int target, unsigned int name);
+        using GetIntegervFn    = void(IMGUIWRAP_GLAPI*)(unsigned int name, int* values);
+        using TexParameteriFn  = void(IMGUIWRAP_GLAPI*)(unsigned int target, unsigned int name,
+                                                        int value);
+        using TexImage2DFn     = void(IMGUIWRAP_GLAPI*)(unsigned int target, int level,
+                                                        int internalFormat, int width,
+                                                        int height, int border,
+                                                        unsigned int format, unsigned int type,
+                                                        const void* pixels);
+        using TexSubImage2DFn  = void(IMGUIWRAP_GLAPI*)(unsigned int target, int level, int x,
+                                                        int y, int width, int height,
+                                                        unsigned int format, unsigned int type,
+                                                        const void* pixels);
+        using BufferDataFn     = void(IMGUIWRAP_GLAPI*)(unsigned int target, ptrdiff_t size,
+                                                        const void* data, unsigned int usage);
+        using MapBufferRangeFn = void*(IMGUIWRAP_GLAPI*)(unsigned int target, ptrdiff_t offset,
+                                                         ptrdiff_t length, unsigned int access);
+        using UnmapBufferFn    = unsigned char(IMGUIWRAP_GLAPI*)(unsigned int target);
+
+        bool resolved_{false};
+
+        GenFn           genTextures_{nullptr};
+        DeleteFn        deleteTextures_{nullptr};
+        BindFn          bindTexture_{nullptr};
+        GetIntegervFn   getIntegerv_{nullptr};
+        TexParameteriFn texParameteri_{nullptr};
+        TexImage2DFn    texImage2D_{nullptr};
+        TexSubImage2DFn texSubImage2D_{nullptr};
+
+        // Pixel buffer objects (GL 2.1 / GLES 3, mapped with GL 3.0's glMapBufferRange).
+        GenFn            genBuffers_{nullptr};
+        DeleteFn         deleteBuffers_{nullptr};
+        BindFn           bindBuffer_{nullptr};
+        BufferDataFn     bufferData_{nullptr};
+        MapBufferRangeFn mapBufferRange_{nullptr};
+        UnmapBufferFn    unmapBuffer_{nullptr};
+
+        bool HasTextures() const noexcept
+        {
+            return genTextures_ != nullptr && deleteTextures_ != nullptr &&
+                   bindTexture_ != nullptr && getIntegerv_ != nullptr &&
+                   texParameteri_ != nullptr && texImage2D_ != nullptr &&
+                   texSubImage2D_ != nullptr;
+        }
+
+        bool HasPixelBuffers() const noexcept
+        {
+            return genBuffers_ != nullptr && deleteBuffers_ != nullptr &&
+                   bindBuffer_ != nullptr && bufferData_ != nullptr &&
+                   mapBufferRange_ != nullptr && unmapBuffer_ != nullptr;
+        }
+    };
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    GlFunctions gl;
+
+    // streamTextures lists the stream textures that exist, only touched on the UI thread. It
+    // is constructed on first use, so StreamTextures with static storage duration can
+    // register themselves whatever order their translation units are initialized in.
+    std::vector<dear::StreamTexture*>&
+    streamTextures() noexcept
+    {
+        static std::vector<dear::StreamTexture*> textures;
+        return textures;
+    }
+
+    template<typename Fn>
+    Fn
+    glProc(const char* name) noexcept
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return reinterpret_cast<Fn>(glfwGetProcAddress(name));
+    }
+
+    void
+    resolveGl() noexcept
+    {
+        gl.genTextures_    = glProc<GlFunctions::GenFn>("glGenTextures");
+        gl.deleteTextures_ = glProc<GlFunctions::DeleteFn>("glDeleteTextures");
+        gl.bindTexture_    = glProc<GlFunctions::BindFn>("glBindTexture");
+        gl.getIntegerv_    = glProc<GlFunctions::GetIntegervFn>("glGetIntegerv");
+        gl.texParameteri_  = glProc<GlFunctions::TexParameteriFn>("glTexParameteri");
+        gl.texImage2D_     = glProc<GlFunctions::TexImage2DFn>("glTexImage2D");
+        gl.texSubImage2D_  = glProc<GlFunctions::TexSubImage2DFn>("glTexSubImage2D");
+
+        gl.genBuffers_     = glProc<GlFunctions::GenFn>("glGenBuffers");
+        gl.deleteBuffers_  = glProc<GlFunctions::DeleteFn>("glDeleteBuffers");
+        gl.bindBuffer_     = glProc<GlFunctions::BindFn>("glBindBuffer");
+        gl.bufferData_     = glProc<GlFunctions::BufferDataFn>("glBufferData");
+        gl.mapBufferRange_ = glProc<GlFunctions::MapBufferRangeFn>("glMapBufferRange");
+        gl.unmapBuffer_    = glProc<GlFunctions::UnmapBufferFn>("glUnmapBuffer");
+
+        gl.resolved_ = true;
+        if (!gl.HasTextures()) {
+            (void) fprintf(stderr, "imguiwrap: no GL texture functions, stream textures won't "
+                                   "be uploaded\n");
+        }
+    }
+
+    int64_t
+    nowNs() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   Clock::now().time_since_epoch())
+            .count();
+    }
+}  // namespace
+
+namespace dear
+{
+    StreamTexture::StreamTexture(int width, int height) noexcept
+        : width_(std::max(width, 1))
+        , height_(std::max(height, 1))
+        , frameBytes_(static_cast<size_t>(width_) * static_cast<size_t>(height_) * 4)
+        , staging_(frameBytes_ * 3)
+    {
+        streamTextures().push_back(this);
+    }
+
+    StreamTexture::~StreamTexture()
+    {
+        Release();
+        std::vector<StreamTexture*>& textures = streamTextures();
+        textures.erase(std::remove(textures.begin(), textures.end(), this), textures.end());
+    }
+
+    uint8_t* StreamTexture::BeginFrame() noexcept
+    {
+        producerMutex_.lock();
+        return staging_.data() + back_ * frameBytes_;
+    }
+
+    void StreamTexture::EndFrame() noexcept
+    {
+        sequence_[back_]    = ++nextSequence_;
+        publishedAt_[back_] = nowNs();
+        // Swap the new frame into the middle, taking whatever was there to fill next.
+        const unsigned int previous = middle_.exchange(back_ | Fresh, std::memory_order_acq_rel);
+        if ((previous & Fresh) != 0) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+        back_ = previous & IndexMask;
+        published_.fetch_add(1, std::memory_order_relaxed);
+        producerMutex_.unlock();
+    }
+
+    void StreamTexture::Publish(const void* pixels, size_t stride) noexcept
+    {
+        const size_t rowBytes = static_cast<size_t>(width_) * 4;
+        const auto*  src      = static_cast<const uint8_t*>(pixels);
+        uint8_t*     dst      = BeginFrame();
+        if (stride == 0 || stride == rowBytes) {
+            (void) memcpy(dst, src, frameBytes_);
+        } else {
+            for (int row = 0; row < height_; ++row) {
+                (void) memcpy(dst, src, rowBytes);
+                dst += rowBytes;
+                src += stride;
+            }
+        }
+        EndFrame();
+    }
+
+    ImTextureID StreamTexture::TextureID() const noexcept
+    {
+        if (shownSequence_ == 0) {
+            return ImTextureID{};
+        }
+        // The OpenGL3 backend's texture IDs are GLuint texture names.
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast,performance-no-int-to-ptr)
+        return reinterpret_cast<ImTextureID>(static_cast<intptr_t>(texture_));
+    }
+
+    void StreamTexture::Image(const ImVec2& size, const ImVec2& uv0,
+                              const ImVec2& uv1) const noexcept
+    {
+        const ImTextureID id = TextureID();
+        if (id == ImTextureID{}) {
+            ImGui::Dummy(size);
+        } else {
+            ImGui::Image(id, size, uv0, uv1);
+        }
+    }
+
+    StreamTextureStats StreamTexture::Stats() const noexcept
+    {
+        StreamTextureStats stats{};
+        stats.published_     = published_.load(std::memory_order_relaxed);
+        stats.dropped_       = dropped_.load(std::memory_order_relaxed);
+        stats.uploaded_      = uploaded_;
+        stats.bytesUploaded_ = bytesUploaded_;
+        stats.uploadMs_      = lastUploadMs_;
+        stats.ageMs_         = lastAgeMs_;
+        stats.pixelBuffers_  = pixelBuffers_[0] != 0;
+        if (uploadNs_ > 0) {
+            stats.uploadMBps_ = static_cast<float>(static_cast<double>(bytesUploaded_) * 1e3 /
+                                                   static_cast<double>(uploadNs_));
+        }
+        return stats;
+    }
+
+    void StreamTexture::Upload() noexcept
+    {
+        if ((middle_.load(std::memory_order_relaxed) & Fresh) == 0) {
+            return;
+        }
+        const int64_t start = nowNs();
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & IndexMask;
+        const uint8_t* pixels = staging_.data() + front_ * frameBytes_;
+
+        int previousTexture{0};
+        gl.getIntegerv_(TextureBinding2D, &previousTexture);
+        if (texture_ == 0) {
+            gl.genTextures_(1, &texture_);
+            gl.bindTexture_(Texture2D, texture_);
+            gl.texParameteri_(Texture2D, TextureMinFilter, Linear);
+            gl.texParameteri_(Texture2D, TextureMagFilter, Linear);
+            gl.texParameteri_(Texture2D, TextureWrapS, ClampToEdge);
+            gl.texParameteri_(Texture2D, TextureWrapT, ClampToEdge);
+            gl.texImage2D_(Texture2D, 0, static_cast<int>(Rgba), width_, height_, 0, Rgba,
+                           UnsignedByte, nullptr);
+            if (gl.HasPixelBuffers()) {
+                gl.genBuffers_(static_cast<int>(pixelBuffers_.size()), pixelBuffers_.data());
+            }
+        } else {
+            gl.bindTexture_(Texture2D, texture_);
+        }
+
+        bool uploaded = false;
+        if (pixelBuffers_[0] != 0) {
+            // Alternate between the buffers, and orphan the storage before mapping it, so
+            // that the driver never has to wait for the previous transfer from it.
+            const auto bytes = static_cast<ptrdiff_t>(frameBytes_);
+            gl.bindBuffer_(PixelUnpackBuffer, pixelBuffers_[nextPixelBuffer_]);
+            nextPixelBuffer_ = (nextPixelBuffer_ + 1) % pixelBuffers_.size();
+            gl.bufferData_(PixelUnpackBuffer, bytes, nullptr, StreamDraw);
+            void* mapped =
+                gl.mapBufferRange_(PixelUnpackBuffer, 0, bytes, MapWrite | MapInvalidate);
+            if (mapped != nullptr) {
+                (void) memcpy(mapped, pixels, frameBytes_);
+                (void) gl.unmapBuffer_(PixelUnpackBuffer);
+                gl.texSubImage2D_(Texture2D, 0, 0, 0, width_, height_, Rgba, UnsignedByte,
+                                  nullptr);
+                uploaded = true;
+            }
+            gl.bindBuffer_(PixelUnpackBuffer, 0);
+        }
+        if (!uploaded) {
+            gl.texSubImage2D_(Texture2D, 0, 0, 0, width_, height_, Rgba, UnsignedByte, pixels);
+        }
+        gl.bindTexture_(Texture2D, static_cast<unsigned int>(previousTexture));
+
+        const int64_t end = nowNs();
+        shownSequence_    = sequence_[front_];
+        ++uploaded_;
+        bytesUploaded_ += frameBytes_;
+        uploadNs_ += end - start;
+        lastUploadMs_ = static_cast<float>(end - start) / 1e6F;
+        lastAgeMs_    = static_cast<float>(end - publishedAt_[front_]) / 1e6F;
+    }
+
+    void StreamTexture::Release() noexcept
+    {
+        if (texture_ == 0) {
+            return;
+        }
+        if (pixelBuffers_[0] != 0) {
+            gl.deleteBuffers_(static_cast<int>(pixelBuffers_.size()), pixelBuffers_.data());
+            pixelBuffers_.fill(0);
+        }
+        gl.deleteTextures_(1, &texture_);
+        texture_       = 0;
+        shownSequence_ = 0;
+    }
+
+    namespace detail
+    {
+        void StreamTexturesUpload() noexcept
+        {
+            if (streamTextures().empty()) {
+                return;
+            }
+            if (!gl.resolved_) {
+                resolveGl();
+            }
+            if (!gl.HasTextures()) {
+                return;
+            }
+            for (StreamTexture* texture : streamTextures()) {
+                texture->Upload();
+            }
+        }
+
+        void StreamTexturesStop() noexcept
+        {
+            for (StreamTexture* texture : streamTextures()) {
+                texture->Release();
+            }
+            gl = GlFunctions{};
+        }
+    }  // namespace detail
+}  // namespace dear
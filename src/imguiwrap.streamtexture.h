@@ -0,0 +1,150 @@
+#pragma once
+
+// dear::StreamTexture is an RGBA image that other threads stream frames into (camera or
+// video frames, heatmaps), displayed with ImGui::Image:
+//
+//   static dear::StreamTexture preview(640, 480);   // created on the UI thread
+//
+//   // on a capture thread:
+//   uint8_t* pixels = preview.BeginFrame();           // width * 4 bytes per row
+//   camera.Decode(pixels);
+//   preview.EndFrame();
+//
+//   // in mainFn:
+//   preview.Image(ImVec2(640, 480));
+//
+// Frames go through three staging buffers: producers fill one while another holds the
+// newest complete frame and the UI thread reads the third. Nobody waits: a producer that
+// publishes faster than the UI runs replaces the frame that hasn't been shown yet (counted
+// as dropped), and the UI thread never waits for a producer.
+//
+// imgui_main uploads the newest frame of every stream texture once per frame, between
+// ImGui::Render and rendering the draw data, so Image shows the frame that was newest when
+// the frame was rendered. Where the context has pixel buffer objects (GL 3.x, GLES 3) the
+// frame is copied into one and the texture is updated from it, so the driver transfers it
+// asynchronously instead of stalling the frame; otherwise it falls back to glTexSubImage2D
+// from the staging buffer.
+//
+// Create and destroy stream textures on the UI thread. Frames can be published from any
+// thread; BeginFrame/EndFrame pairs from different threads take turns.
+
+#include "imgui.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace dear
+{
+    namespace detail
+    {
+        // StreamTexturesUpload uploads the newest frame of each stream texture; imgui_main
+        // calls it before rendering the draw data, with the GL context current.
+        extern void StreamTexturesUpload() noexcept;
+
+        // StreamTexturesStop releases the GL objects of the stream textures that still
+        // exist, before the GL context is destroyed.
+        extern void StreamTexturesStop() noexcept;
+    }  // namespace detail
+
+    // StreamTextureStats describes a stream texture's frames and uploads.
+    struct StreamTextureStats
+    {
+        // published_ frames were completed by producers; uploaded_ were sent to the
+        // texture, and dropped_ were replaced by newer frames before they could be.
+        uint64_t published_{0};
+        uint64_t uploaded_{0};
+        uint64_t dropped_{0};
+        uint64_t bytesUploaded_{0};
+
+        // uploadMs_ is the UI-thread time the last upload took, and uploadMBps_ the rate
+        // of all uploads so far over the UI-thread time they took.
+        float uploadMs_{0.0F};
+        float uploadMBps_{0.0F};
+
+        // ageMs_ is how old the last uploaded frame was, from EndFrame to its upload.
+        float ageMs_{0.0F};
+
+        // pixelBuffers_ is true if uploads go through pixel buffer objects.
+        bool pixelBuffers_{false};
+    };
+
+    class StreamTexture
+    {
+    public:
+        StreamTexture(int width, int height) noexcept;
+        ~StreamTexture();
+
+        StreamTexture(const StreamTexture&) = delete;
+        StreamTexture& operator=(const StreamTexture&) = delete;
+
+        int    Width() const noexcept { return width_; }
+        int    Height() const noexcept { return height_; }
+        size_t FrameBytes() const noexcept { return frameBytes_; }
+
+        // BeginFrame returns a buffer of Height() rows of Width() RGBA pixels to fill with
+        // the next frame, which EndFrame publishes. The buffer may hold an older frame.
+        uint8_t* BeginFrame() noexcept;
+        void     EndFrame() noexcept;
+
+        // Publish copies a frame whose rows are stride bytes apart (0 for tightly packed).
+        void Publish(const void* pixels, size_t stride = 0) noexcept;
+
+        // TextureID is null until the first frame has been uploaded.
+        ImTextureID TextureID() const noexcept;
+
+        // Sequence is the number of the frame being shown, counting from 1 in the order
+        // frames were published, or zero if none has been.
+        uint64_t Sequence() const noexcept { return shownSequence_; }
+
+        // Image draws the newest uploaded frame, or reserves the space if there isn't one.
+        void Image(const ImVec2& size, const ImVec2& uv0 = ImVec2(0, 0),
+                   const ImVec2& uv1 = ImVec2(1, 1)) const noexcept;
+
+        StreamTextureStats Stats() const noexcept;
+
+    private:
+        friend void detail::StreamTexturesUpload() noexcept;
+        friend void detail::StreamTexturesStop() noexcept;
+
+        void Upload() noexcept;
+        void Release() noexcept;
+
+        // middle_ holds the index of the staging buffer with the newest published frame,
+        // plus Fresh if it hasn't been taken by the UI thread yet.
+        static constexpr unsigned int Fresh     = 4;
+        static constexpr unsigned int IndexMask = 3;
+
+        const int    width_;
+        const int    height_;
+        const size_t frameBytes_;
+
+        std::vector<uint8_t>      staging_;  // three frames
+        std::array<uint64_t, 3>   sequence_{};
+        std::array<int64_t, 3>    publishedAt_{};  // steady_clock nanoseconds
+        std::atomic<unsigned int> middle_{1};
+
+        // Producer side, under producerMutex_ between BeginFrame and EndFrame.
+        std::mutex   producerMutex_;
+        unsigned int back_{0};
+        uint64_t     nextSequence_{0};
+
+        std::atomic<uint64_t> published_{0};
+        std::atomic<uint64_t> dropped_{0};
+
+        // UI thread.
+        unsigned int                front_{2};
+        uint64_t                    shownSequence_{0};
+        unsigned int                texture_{0};
+        std::array<unsigned int, 2> pixelBuffers_{};
+        unsigned int                nextPixelBuffer_{0};
+        uint64_t                    uploaded_{0};
+        uint64_t                    bytesUploaded_{0};
+        int64_t                     uploadNs_{0};
+        float                       lastUploadMs_{0.0F};
+        float                       lastAgeMs_{0.0F};
+    };
+}  // namespace dear
@@ -0,0 +1,94 @@
+// Scheduler for dear::Task coroutines; see imguiwrap.task.h.
+
+#include "imguiwrap.task.h"
+
+#ifdef IMGUIWRAP_COROUTINES
+
+#    include <deque>
+#    include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Only ever touched from the UI thread.
+    struct Scheduler
+    {
+        // Tasks waiting to be resumed, in the order they will be resumed.
+        std::deque<dear::Task::Handle> pending_;
+
+        // Tasks that yielded during the current frame; they join pending_ next frame.
+        std::vector<dear::Task::Handle> yielded_;
+
+        Clock::time_point sliceStart_{};
+        Clock::time_point frameDeadline_{Clock::time_point::max()};
+    };
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    Scheduler scheduler;
+
+    void
+    destroyTask(dear::Task::Handle handle) noexcept
+    {
+        handle.promise().state_->done_ = true;
+        handle.destroy();
+    }
+
+}  // namespace
+
+namespace dear
+{
+    size_t PendingTasks() noexcept { return scheduler.pending_.size() + scheduler.yielded_.size(); }
+
+    namespace detail
+    {
+        void TaskYield(Task::Handle handle) noexcept { scheduler.yielded_.push_back(handle); }
+
+        void TaskBeginSlice() noexcept { scheduler.sliceStart_ = Clock::now(); }
+
+        bool TaskSliceExpired(Clock::duration slice) noexcept
+        {
+            const auto now = Clock::now();
+            return now - scheduler.sliceStart_ >= slice || now >= scheduler.frameDeadline_;
+        }
+
+        void TasksRun(Clock::duration budget) noexcept
+        {
+            scheduler.pending_.insert(scheduler.pending_.end(), scheduler.yielded_.begin(),
+                                      scheduler.yielded_.end());
+            scheduler.yielded_.clear();
+
+            scheduler.frameDeadline_ = Clock::now() + budget;
+            // Tasks resumed here that yield again go to yielded_, so this terminates.
+            for (bool first = true; !scheduler.pending_.empty(); first = false) {
+                if (!first && Clock::now() >= scheduler.frameDeadline_) {
+                    break;
+                }
+                const Task::Handle handle = scheduler.pending_.front();
+                scheduler.pending_.pop_front();
+                if (handle.promise().state_->cancelled_) {
+                    destroyTask(handle);
+                    continue;
+                }
+                TaskBeginSlice();
+                handle.resume();
+            }
+            // Tasks started outside of TasksRun aren't bound by the frame's task budget.
+            scheduler.frameDeadline_ = Clock::time_point::max();
+        }
+
+        void TasksShutdown() noexcept
+        {
+            for (const auto handle : scheduler.pending_) {
+                destroyTask(handle);
+            }
+            for (const auto handle : scheduler.yielded_) {
+                destroyTask(handle);
+            }
+            scheduler.pending_.clear();
+            scheduler.yielded_.clear();
+        }
+    }  // namespace detail
+}  // namespace dear
+
+#endif  // IMGUIWRAP_COROUTINES
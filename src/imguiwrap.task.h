@@ -0,0 +1,153 @@
+#pragma once
+
+// Coroutine-based UI tasks (requires IMGUIWRAP_CXX_STANDARD 20 or higher).
+//
+// A dear::Task is a coroutine that runs on the UI thread and spreads its work over several
+// frames by awaiting either the next frame, or the end of its time slice:
+//
+//   dear::Task Reindex(Index& index)
+//   {
+//       using namespace std::chrono_literals;
+//       for (auto& file : index.files_) {
+//           index.Add(file);
+//           co_await dear::Budget(2ms);  // yield if this slice has run for 2ms
+//       }
+//       co_await dear::NextFrame();      // always yield
+//       index.Publish();
+//   }
+//
+//   static dear::Task reindex;
+//   if (ImGui::Button("Reindex") && reindex.Done())
+//       reindex = Reindex(index);
+//
+// A task runs immediately when called, until its first suspension. imgui_main then resumes
+// suspended tasks once per frame, after your render function returns and before
+// ImGui::Render (so tasks may still submit widgets), stopping once the frame's task budget
+// (ImGuiWrapConfig::taskBudgetMs_) is spent; tasks not reached run first next frame.
+//
+// Tasks must only be started and awaited on the UI thread. Dropping a Task does not stop
+// the coroutine; use Cancel(), which destroys it (running the destructors of its locals)
+// instead of resuming it.
+
+#ifdef IMGUIWRAP_COROUTINES
+
+#    if !defined(__cpp_impl_coroutine) || !__has_include(<coroutine>)
+#        error "IMGUIWRAP_COROUTINES requires a compiler with C++20 coroutine support"
+#    endif
+
+#    include <chrono>
+#    include <coroutine>
+#    include <cstddef>
+#    include <exception>
+#    include <memory>
+#    include <utility>
+
+namespace dear
+{
+    namespace detail
+    {
+        // TaskState outlives the coroutine frame, so that a Task can still be queried after
+        // its coroutine has finished and been destroyed.
+        struct TaskState
+        {
+            bool done_{false};
+            bool cancelled_{false};
+        };
+    }  // namespace detail
+
+    class Task
+    {
+    public:
+        struct promise_type
+        {
+            std::shared_ptr<detail::TaskState> state_{std::make_shared<detail::TaskState>()};
+
+            Task               get_return_object() noexcept { return Task(state_); }
+            std::suspend_never initial_suspend() noexcept;
+            std::suspend_never final_suspend() noexcept
+            {
+                state_->done_ = true;
+                return {};
+            }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+
+        using Handle = std::coroutine_handle<promise_type>;
+
+        // A default-constructed Task is Done.
+        Task() noexcept = default;
+
+        bool Done() const noexcept { return state_ == nullptr || state_->done_; }
+
+        // Cancel stops the task at its next suspension point; if it is currently
+        // suspended, it will not be resumed again.
+        void Cancel() noexcept
+        {
+            if (state_ != nullptr) {
+                state_->cancelled_ = true;
+            }
+        }
+
+    private:
+        explicit Task(std::shared_ptr<detail::TaskState> state) noexcept : state_(std::move(state))
+        {}
+
+        std::shared_ptr<detail::TaskState> state_;
+    };
+
+    namespace detail
+    {
+        // TaskYield queues a suspended task to be resumed next frame.
+        extern void TaskYield(Task::Handle handle) noexcept;
+
+        // TaskBeginSlice marks the start of a task's time slice.
+        extern void TaskBeginSlice() noexcept;
+
+        // TaskSliceExpired is true if the current slice has run for at least 'slice', or
+        // the frame's task budget has been spent.
+        extern bool TaskSliceExpired(std::chrono::steady_clock::duration slice) noexcept;
+
+        // TasksRun resumes the queued tasks until 'budget' has elapsed; at least one is
+        // resumed each frame so that tasks always make progress.
+        extern void TasksRun(std::chrono::steady_clock::duration budget) noexcept;
+
+        // TasksShutdown destroys any tasks that are still suspended.
+        extern void TasksShutdown() noexcept;
+    }  // namespace detail
+
+    inline std::suspend_never Task::promise_type::initial_suspend() noexcept
+    {
+        detail::TaskBeginSlice();
+        return {};
+    }
+
+    // NextFrame suspends the task until the next frame.
+    struct NextFrame
+    {
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(Task::Handle handle) const noexcept { detail::TaskYield(handle); }
+        void await_resume() const noexcept {}
+    };
+
+    // Budget suspends the task until the next frame if it has been running for longer than
+    // 'slice' since it was last resumed (or the frame's task budget is spent), and otherwise
+    // continues without suspending.
+    class Budget
+    {
+    public:
+        explicit Budget(std::chrono::steady_clock::duration slice) noexcept : slice_(slice) {}
+
+        bool await_ready() const noexcept { return !detail::TaskSliceExpired(slice_); }
+        void await_suspend(Task::Handle handle) const noexcept { detail::TaskYield(handle); }
+        void await_resume() const noexcept {}
+
+    private:
+        std::chrono::steady_clock::duration slice_;
+    };
+
+    // PendingTasks returns the number of suspended tasks waiting to be resumed.
+    extern size_t PendingTasks() noexcept;
+}  // namespace dear
+
+#endif  // IMGUIWRAP_COROUTINES
@@ -0,0 +1,267 @@
+#include "imguiwrap.virtualtree.h"
+
+#include "imgui_internal.h"
+
+#include <iterator>
+#include <utility>
+
+namespace dear
+{
+    VirtualTree::VirtualTree(ChildrenFn children, HasChildrenFn hasChildren, LabelFn label) noexcept
+        : children_(std::move(children))
+        , hasChildren_(std::move(hasChildren))
+        , label_(std::move(label))
+    {}
+
+    void VirtualTree::appendSubtree(NodeId parent, uint32_t depth, bool openAll,
+                                    std::vector<Row>& out) noexcept
+    {
+        // Iterative depth-first walk, so that deep hierarchies can't exhaust the stack.
+        struct Pending
+        {
+            std::vector<NodeId> nodes_;
+            size_t              next_;
+            uint32_t            depth_;
+            NodeId              parent_;
+        };
+        std::vector<Pending> stack;
+
+        scratch_.clear();
+        children_(parent, scratch_);
+        stack.push_back(Pending{scratch_, 0, depth, parent});
+
+        while (!stack.empty()) {
+            Pending& top = stack.back();
+            if (top.next_ == top.nodes_.size()) {
+                stack.pop_back();
+                continue;
+            }
+            const NodeId   node      = top.nodes_[top.next_++];
+            const uint32_t nodeDepth = top.depth_;
+
+            Row row{node, top.parent_, nodeDepth, Kind::Unknown, false};
+            if (!openAll && open_.count(node) == 0) {
+                out.push_back(row);
+                continue;
+            }
+
+            // Open node: its children are needed now, which also tells us if it's a leaf.
+            std::vector<NodeId> nodeChildren;
+            children_(node, nodeChildren);
+            if (nodeChildren.empty()) {
+                row.kind_ = Kind::Leaf;
+                open_.erase(node);
+                out.push_back(row);
+                continue;
+            }
+            row.kind_ = Kind::Branch;
+            row.open_ = true;
+            open_.insert(node);
+            parents_[node] = row.parent_;
+            out.push_back(row);
+            // 'top' is invalidated by the push_back.
+            stack.push_back(Pending{std::move(nodeChildren), 0, nodeDepth + 1, node});
+        }
+    }
+
+    size_t VirtualTree::findRow(NodeId node) noexcept
+    {
+        if (!indexed_) {
+            rowIndex_.clear();
+            rowIndex_.reserve(rows_.size());
+            for (size_t i = 0; i < rows_.size(); ++i) {
+                rowIndex_.emplace(rows_[i].id_, i);
+            }
+            indexed_ = true;
+        }
+        const auto it = rowIndex_.find(node);
+        return it != rowIndex_.end() ? it->second : rows_.size();
+    }
+
+    bool VirtualTree::descends(NodeId node, NodeId ancestor) const noexcept
+    {
+        // Bounded by the number of known parents, in case the hierarchy has changed into
+        // something with a cycle in it.
+        for (size_t steps = 0; steps <= parents_.size(); ++steps) {
+            const auto it = parents_.find(node);
+            if (it == parents_.end()) {
+                return false;
+            }
+            node = it->second;
+            if (node == ancestor) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t VirtualTree::subtreeEnd(size_t index) const noexcept
+    {
+        const uint32_t depth = rows_[index].depth_;
+        size_t         end   = index + 1;
+        while (end < rows_.size() && rows_[end].depth_ > depth) {
+            ++end;
+        }
+        return end;
+    }
+
+    void VirtualTree::expandRow(size_t index, bool all) noexcept
+    {
+        if (rows_[index].kind_ == Kind::Leaf || (rows_[index].open_ && !all)) {
+            return;
+        }
+        indexed_ = false;
+        if (rows_[index].open_) {
+            // Expanding everything below an open node: replace its current rows.
+            rows_.erase(rows_.begin() + static_cast<ptrdiff_t>(index + 1),
+                        rows_.begin() + static_cast<ptrdiff_t>(subtreeEnd(index)));
+        }
+
+        Row&             row = rows_[index];
+        std::vector<Row> subtree;
+        appendSubtree(row.id_, row.depth_ + 1, all, subtree);
+        if (subtree.empty()) {
+            row.kind_ = Kind::Leaf;
+            row.open_ = false;
+            open_.erase(row.id_);
+            return;
+        }
+        row.kind_ = Kind::Branch;
+        row.open_ = true;
+        open_.insert(row.id_);
+        parents_[row.id_] = row.parent_;
+        rows_.insert(rows_.begin() + static_cast<ptrdiff_t>(index + 1), subtree.begin(),
+                     subtree.end());
+    }
+
+    void VirtualTree::collapseRow(size_t index, bool all) noexcept
+    {
+        const size_t end = subtreeEnd(index);
+        if (all) {
+            // Open nodes below collapsed ones have no rows, so look through the open set.
+            const NodeId node = rows_[index].id_;
+            for (auto it = open_.begin(); it != open_.end();) {
+                it = descends(*it, node) ? open_.erase(it) : std::next(it);
+            }
+        }
+        indexed_ = false;
+        rows_.erase(rows_.begin() + static_cast<ptrdiff_t>(index + 1),
+                    rows_.begin() + static_cast<ptrdiff_t>(end));
+        rows_[index].open_ = false;
+        open_.erase(rows_[index].id_);
+    }
+
+    void VirtualTree::Expand(NodeId node) noexcept
+    {
+        if (const size_t index = findRow(node); index < rows_.size()) {
+            expandRow(index, false);
+        }
+    }
+
+    void VirtualTree::Collapse(NodeId node) noexcept
+    {
+        if (const size_t index = findRow(node); index < rows_.size() && rows_[index].open_) {
+            collapseRow(index, false);
+        }
+    }
+
+    void VirtualTree::ExpandAll(NodeId node) noexcept
+    {
+        if (node == RootNode) {
+            rows_.clear();
+            appendSubtree(RootNode, 0, true, rows_);
+            built_   = true;
+            indexed_ = false;
+        } else if (const size_t index = findRow(node); index < rows_.size()) {
+            expandRow(index, true);
+        }
+    }
+
+    void VirtualTree::CollapseAll() noexcept
+    {
+        open_.clear();
+        parents_.clear();
+        Refresh();
+    }
+
+    void VirtualTree::Refresh() noexcept
+    {
+        rows_.clear();
+        appendSubtree(RootNode, 0, false, rows_);
+        built_   = true;
+        indexed_ = false;
+    }
+
+    bool VirtualTree::Draw(const char* str_id, const ImVec2& size) noexcept
+    {
+        if (!built_) {
+            Refresh();
+        }
+
+        bool changed = false;
+        dear::Child(str_id, size) && [&] {
+            const float indent     = ImGui::GetStyle().IndentSpacing;
+            const float arrowWidth = ImGui::GetTreeNodeToLabelSpacing();
+            const float baseX      = ImGui::GetCursorPosX();
+            const ImU32 arrowColor = ImGui::GetColorU32(ImGuiCol_Text);
+
+            // Toggles are applied after the clipper has finished with rows_.
+            size_t toggle    = rows_.size();
+            bool   toggleAll = false;
+
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(rows_.size()), ImGui::GetTextLineHeightWithSpacing());
+            while (clipper.Step()) {
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                    Row& row = rows_[static_cast<size_t>(i)];
+                    if (row.kind_ == Kind::Unknown) {
+                        row.kind_ = hasChildren_(row.id_) ? Kind::Branch : Kind::Leaf;
+                    }
+
+                    // Keyed by the node rather than the row, so that state of the row's
+                    // widgets stays with its node when rows above are expanded or collapsed.
+                    const auto* idBytes = reinterpret_cast<const char*>(&row.id_);
+                    ImGui::PushID(idBytes, idBytes + sizeof(row.id_));
+                    const float x = baseX + static_cast<float>(row.depth_) * indent;
+                    ImGui::SetCursorPosX(x);
+                    if (row.kind_ == Kind::Branch) {
+                        const ImVec2 arrowPos  = ImGui::GetCursorScreenPos();
+                        const ImVec2 arrowSize = ImVec2(arrowWidth, ImGui::GetTextLineHeight());
+                        if (ImGui::InvisibleButton("##toggle", arrowSize)) {
+                            toggle    = static_cast<size_t>(i);
+                            toggleAll = ImGui::GetIO().KeyShift;
+                        }
+                        ImGui::RenderArrow(ImGui::GetWindowDrawList(), arrowPos, arrowColor,
+                                           row.open_ ? ImGuiDir_Down : ImGuiDir_Right);
+                        ImGui::SameLine(0.0f, 0.0f);
+                    } else {
+                        ImGui::SetCursorPosX(x + arrowWidth);
+                    }
+
+                    const bool isSelected = hasSelection_ && selected_ == row.id_;
+                    if (ImGui::Selectable(label_(row.id_), isSelected,
+                                          ImGuiSelectableFlags_AllowDoubleClick)) {
+                        if (!isSelected) {
+                            Select(row.id_);
+                            changed = true;
+                        }
+                        if (row.kind_ == Kind::Branch &&
+                            ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left)) {
+                            toggle = static_cast<size_t>(i);
+                        }
+                    }
+                    ImGui::PopID();
+                }
+            }
+
+            if (toggle < rows_.size()) {
+                if (rows_[toggle].open_) {
+                    collapseRow(toggle, toggleAll);
+                } else {
+                    expandRow(toggle, toggleAll);
+                }
+            }
+        };
+        return changed;
+    }
+}  // namespace dear
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "imguiwrap.dear.h"
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace dear
+{
+    // VirtualTree renders hierarchies with millions of nodes.
+    //
+    // Unlike dear::TreeNode, which submits one ImGui::TreeNode per node every frame, it keeps
+    // a flattened list of the currently visible rows, which is only updated when a node is
+    // expanded or collapsed, and draws just the rows that fall inside the clip rect.
+    //
+    // The hierarchy itself stays with the caller, who describes it via three callbacks:
+    //
+    //   dear::VirtualTree tree(
+    //       [&](NodeId parent, std::vector<NodeId>& out) { ...append children of parent... },
+    //       [&](NodeId node) { return hasChildren(node); },
+    //       [&](NodeId node) { return labelOf(node); });
+    //   ...
+    //   dear::Begin("Symbols") && [&] { tree.Draw("##symbols"); };
+    //
+    // If the hierarchy changes, call Refresh() to rebuild the visible rows.
+    class VirtualTree
+    {
+    public:
+        using NodeId = uint64_t;
+
+        // RootNode is passed to the ChildrenFn to enumerate the top-level nodes.
+        static constexpr NodeId RootNode = ~NodeId{0};
+
+        // ChildrenFn appends the children of 'parent' to 'out'.
+        using ChildrenFn = std::function<void(NodeId parent, std::vector<NodeId>& out)>;
+
+        // HasChildrenFn says whether a node can be expanded, without enumerating it. It is
+        // only called for nodes as they scroll into view.
+        using HasChildrenFn = std::function<bool(NodeId node)>;
+
+        // LabelFn returns the text to display for a node. The pointer only needs to remain
+        // valid until the next call.
+        using LabelFn = std::function<const char*(NodeId node)>;
+
+        VirtualTree(ChildrenFn children, HasChildrenFn hasChildren, LabelFn label) noexcept;
+
+        // Draw renders the visible portion of the tree inside a child window of the given
+        // size, and returns true if the selection changed.
+        // Clicking the arrow or double-clicking a node toggles it; shift-clicking the arrow
+        // expands or collapses the whole subtree.
+        bool Draw(const char* str_id, const ImVec2& size = Zero) noexcept;
+
+        // Expand/Collapse open or close a single node, if it is visible. Nodes are found
+        // through an index of the rows, rebuilt on the first lookup after they change.
+        void Expand(NodeId node) noexcept;
+        void Collapse(NodeId node) noexcept;
+
+        // ExpandAll opens every node below 'node' (RootNode for the whole tree), walking
+        // the subtree once rather than on every frame.
+        void ExpandAll(NodeId node = RootNode) noexcept;
+
+        // CollapseAll closes every node.
+        void CollapseAll() noexcept;
+
+        // Refresh rebuilds the visible rows from the callbacks, preserving which nodes are
+        // open. Use it after the hierarchy changes.
+        void Refresh() noexcept;
+
+        // Selection.
+        bool   HasSelection() const noexcept { return hasSelection_; }
+        NodeId Selected() const noexcept { return selected_; }
+        void   Select(NodeId node) noexcept
+        {
+            selected_     = node;
+            hasSelection_ = true;
+        }
+        void ClearSelection() noexcept { hasSelection_ = false; }
+
+        // VisibleCount is the number of rows in the flattened list.
+        size_t VisibleCount() const noexcept { return rows_.size(); }
+
+    private:
+        enum class Kind : uint8_t
+        {
+            Unknown,
+            Leaf,
+            Branch
+        };
+
+        struct Row
+        {
+            NodeId   id_;
+            NodeId   parent_;
+            uint32_t depth_;
+            Kind     kind_;
+            bool     open_;
+        };
+
+        // appendSubtree appends the visible rows below 'parent' to 'out'. If 'openAll' is
+        // set, every node encountered is opened as well.
+        void appendSubtree(NodeId parent, uint32_t depth, bool openAll,
+                           std::vector<Row>& out) noexcept;
+
+        // findRow returns the index of the row for a node, or rows_.size().
+        size_t findRow(NodeId node) noexcept;
+
+        // descends says whether 'node' is below 'ancestor', as far as parents_ knows.
+        bool descends(NodeId node, NodeId ancestor) const noexcept;
+
+        // subtreeEnd returns the index one past the last descendant row of rows_[index].
+        size_t subtreeEnd(size_t index) const noexcept;
+
+        void expandRow(size_t index, bool all) noexcept;
+        void collapseRow(size_t index, bool all) noexcept;
+
+        ChildrenFn    children_;
+        HasChildrenFn hasChildren_;
+        LabelFn       label_;
+
+        std::vector<Row>           rows_;
+        std::unordered_set<NodeId> open_;
+        std::vector<NodeId>        scratch_;
+        bool                       built_{false};
+
+        // parents_ remembers the parent of every node that has been opened, so that
+        // collapsing a subtree also finds the open nodes hidden under collapsed ones.
+        std::unordered_map<NodeId, NodeId> parents_;
+
+        // rowIndex_ maps nodes to their rows; it is rebuilt by findRow after rows_ changes.
+        std::unordered_map<NodeId, size_t> rowIndex_;
+        bool                               indexed_{false};
+
+        NodeId selected_{RootNode};
+        bool   hasSelection_{false};
+    };
+}  // namespace dear